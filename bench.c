@@ -0,0 +1,522 @@
+#include "headers.h"
+#include <time.h>
+
+// Benchmark suite for the scheduler hot paths. Every result is written to a
+// CSV file so runs from different versions can be compared with -b.
+
+#define MAX_RESULTS 128
+#define REPEATS 3
+#define TIMER_HORIZON 100000 // Ticks the benchmark timers are spread over
+
+typedef struct {
+    char name[32];
+    char variant[16];
+    int size;
+    long ops;
+    double ns_per_op;
+    double total_ms;
+} BenchResult;
+
+BenchResult results[MAX_RESULTS];
+int result_count = 0;
+unsigned int bench_seed = 12345;
+
+// Function to read the monotonic clock in nanoseconds
+double nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Function to generate deterministic pseudo-random numbers independent of libc
+int benchRand() {
+    bench_seed = bench_seed * 1103515245 + 12345;
+    return (bench_seed >> 16) & 0x7fff;
+}
+
+// Function to record a benchmark result and print it
+void recordResult(const char* name, const char* variant, int size, long ops, double elapsed_ns) {
+    if (result_count == MAX_RESULTS) return;
+
+    BenchResult* r = &results[result_count++];
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    snprintf(r->variant, sizeof(r->variant), "%s", variant);
+    r->size = size;
+    r->ops = ops;
+    r->ns_per_op = elapsed_ns / ops;
+    r->total_ms = elapsed_ns / 1e6;
+
+    printf("%-14s %-8s %8d %10ld ops %12.1f ns/op %10.2f ms\n",
+           r->name, r->variant, r->size, r->ops, r->ns_per_op, r->total_ms);
+    fflush(stdout);
+}
+
+// Function to generate a trace sorted by arrival with roughly 95% offered load
+Process* generateTrace(int n) {
+    Process* jobs = (Process*)malloc(n * sizeof(Process));
+    int arrival = 0;
+    bench_seed = 12345;
+    for (int i = 0; i < n; i++) {
+        memset(&jobs[i], 0, sizeof(Process));
+        jobs[i].id = i + 1;
+        jobs[i].arrival_time = arrival;
+        jobs[i].runtime = 1 + benchRand() % 20;
+        jobs[i].priority = benchRand() % 11;
+        jobs[i].remaining_time = jobs[i].runtime;
+        jobs[i].start_time = -1;
+        jobs[i].finish_time = -1;
+        jobs[i].last_run_time = -1;
+        jobs[i].ready_since = -1;
+        jobs[i].table_index = -1;
+        jobs[i].bursts[0] = jobs[i].runtime;
+        jobs[i].burst_count = 1;
+        jobs[i].burst_remaining = jobs[i].runtime;
+        arrival += benchRand() % 23;
+    }
+    return jobs;
+}
+
+// Micro: fill a heap with n processes and drain it again
+void benchHeap(int n) {
+    Process* jobs = generateTrace(n);
+
+    for (int variant = 0; variant < 2; variant++) {
+        double best = 0;
+        for (int rep = 0; rep < REPEATS; rep++) {
+            PriorityQueue* pq = createPriorityQueue(n);
+            double start = nowNs();
+            if (variant == 0) {
+                for (int i = 0; i < n; i++) insertPriorityQueue(pq, jobs[i].priority, &jobs[i]);
+                for (int i = 0; i < n; i++) removePriorityQueue(pq);
+            } else {
+                for (int i = 0; i < n; i++) insertPriorityQueue(pq, jobs[i].remaining_time, &jobs[i]);
+                for (int i = 0; i < n; i++) removePriorityQueue(pq);
+            }
+            double elapsed = nowNs() - start;
+            if (rep == 0 || elapsed < best) best = elapsed;
+            destroyPriorityQueue(pq);
+        }
+        recordResult("heap", variant == 0 ? "priority" : "runtime", n, 2L * n, best);
+    }
+
+    free(jobs);
+}
+
+// Micro: steady-state enqueue/dequeue on a circular queue holding n processes
+void benchCircularQueue(int n) {
+    long ops = 4L * n;
+
+    double best = 0;
+    for (int rep = 0; rep < REPEATS; rep++) {
+        CircularQueue* queue = createCircularQueue(n);
+        for (int i = 0; i < n; i++) enqueueCircularQueue(queue, i);
+
+        double start = nowNs();
+        for (long i = 0; i < ops / 2; i++) {
+            enqueueCircularQueue(queue, dequeueCircularQueue(queue));
+        }
+        double elapsed = nowNs() - start;
+        if (rep == 0 || elapsed < best) best = elapsed;
+
+        free(queue->array);
+        free(queue);
+    }
+    recordResult("circular_queue", "rotate", n, ops, best);
+}
+
+// Micro: one-way latency of a Message over a private SysV queue (ping-pong / 2)
+void benchMessageLatency(int round_trips) {
+    int qid = msgget(IPC_PRIVATE, IPC_CREAT | 0600);
+    if (qid == -1) {
+        perror("Error creating benchmark message queue");
+        return;
+    }
+
+    int pid = fork();
+    if (pid == 0) {
+        // Echo every ping back as a pong
+        Message msg;
+        for (int i = 0; i < round_trips; i++) {
+            if (msgrcv(qid, &msg, MESSAGE_SIZE, PROCESS_ARRIVAL, 0) == -1) exit(1);
+            msg.mtype = PROCESS_TERMINATION;
+            if (msgsnd(qid, &msg, MESSAGE_SIZE, 0) == -1) exit(1);
+        }
+        exit(0);
+    }
+
+    Message msg;
+    memset(&msg, 0, sizeof(msg));
+    double start = nowNs();
+    for (int i = 0; i < round_trips; i++) {
+        msg.mtype = PROCESS_ARRIVAL;
+        msg.process.id = i;
+        msgsnd(qid, &msg, MESSAGE_SIZE, 0);
+        msgrcv(qid, &msg, MESSAGE_SIZE, PROCESS_TERMINATION, 0);
+    }
+    double elapsed = nowNs() - start;
+
+    waitpid(pid, NULL, 0);
+    msgctl(qid, IPC_RMID, NULL);
+
+    // Each round trip is two one-way messages
+    recordResult("msg_latency", "one_way", (int)sizeof(Message), 2L * round_trips, elapsed);
+}
+
+// Micro: count the finished processes in a table of n, once over an array of
+// whole Process records and once over the dense state column of a ProcessTable
+void benchTableScan(int n) {
+    Process* jobs = generateTrace(n);
+    ProcessTable* table = createProcessTable(n);
+    for (int i = 0; i < n; i++) {
+        jobs[i].state = benchRand() % 4;
+        addProcessToTable(table, jobs[i]);
+    }
+
+    int scans = n >= 1000000 ? 20 : 200;
+    for (int variant = 0; variant < 2; variant++) {
+        volatile int sink = 0;
+        double best = 0;
+        for (int rep = 0; rep < REPEATS; rep++) {
+            double start = nowNs();
+            for (int s = 0; s < scans; s++) {
+                if (variant == 0) {
+                    int count = 0;
+                    for (int i = 0; i < n; i++) count += jobs[i].state == FINISHED;
+                    sink += count;
+                } else {
+                    sink += countProcessesInState(table, FINISHED);
+                }
+            }
+            double elapsed = nowNs() - start;
+            if (rep == 0 || elapsed < best) best = elapsed;
+        }
+        recordResult("table_scan", variant == 0 ? "aos" : "soa", n, (long)scans * n, best);
+    }
+
+    destroyProcessTable(table);
+    free(jobs);
+}
+
+// Micro: lottery draws among n ticket holders, once by a linear scan over the
+// ticket array and once through the Fenwick tree the scheduler uses
+void benchLottery(int n) {
+    LotteryTree* lottery = createLotteryTree(n);
+    bench_seed = 12345;
+    for (int i = 0; i < n; i++) {
+        setLotteryTickets(lottery, i, (1 + benchRand() % 11) * TICKETS_PER_LEVEL);
+    }
+
+    long draws = n >= 100000 ? 2000 : 100000;
+    for (int variant = 0; variant < 2; variant++) {
+        volatile long sink = 0;
+        double start = nowNs();
+        for (long d = 0; d < draws; d++) {
+            long ticket = ((long)benchRand() << 15 | benchRand()) % lottery->total;
+            if (variant == 0) {
+                int slot = 0;
+                long seen = lottery->tickets[0];
+                while (seen <= ticket) seen += lottery->tickets[++slot];
+                sink += slot;
+            } else {
+                sink += drawLotteryTree(lottery, ticket);
+            }
+        }
+        double elapsed = nowNs() - start;
+        recordResult("lottery_draw", variant == 0 ? "linear" : "fenwick", n, draws, elapsed);
+    }
+
+    destroyLotteryTree(lottery);
+}
+
+// Function used as the callback of the timer benchmark
+long timers_fired = 0;
+void countTimer(Timer* timer) {
+    timers_fired++;
+}
+
+// Micro: timing wheel with n pending timers spread over TIMER_HORIZON ticks.
+// Arming, cancelling every other timer and firing the rest should cost the
+// same per timer whether a thousand or a million are pending.
+void benchTimerWheel(int n) {
+    Timer* timers = malloc(n * sizeof(Timer));
+    TimerWheel* wheel = createTimerWheel(0);
+    bench_seed = 12345;
+
+    double start = nowNs();
+    for (int i = 0; i < n; i++) {
+        initTimer(&timers[i], TIMER_ARRIVAL, i);
+        addTimer(wheel, &timers[i], 1 + ((long)benchRand() << 15 | benchRand()) % TIMER_HORIZON);
+    }
+    recordResult("timer_wheel", "add", n, n, nowNs() - start);
+
+    start = nowNs();
+    for (int i = 0; i < n; i += 2) {
+        cancelTimer(wheel, &timers[i]);
+    }
+    recordResult("timer_wheel", "cancel", n, (n + 1) / 2, nowNs() - start);
+
+    timers_fired = 0;
+    start = nowNs();
+    advanceTimerWheel(wheel, TIMER_HORIZON, countTimer);
+    recordResult("timer_wheel", "fire", n, timers_fired, nowNs() - start);
+
+    destroyTimerWheel(wheel);
+    free(timers);
+}
+
+// Macro: end-to-end replay of a generated trace through the core for every
+// algorithm
+void benchSimulation(int n) {
+    Process* jobs = generateTrace(n);
+    const char* names[] = { "", "hpf", "srtn", "rr" };
+
+    for (int alg = HPF; alg <= RR; alg++) {
+        SimResult sim;
+        double start = nowNs();
+        simulateTrace(jobs, n, alg, 2, &sim);
+        double elapsed = nowNs() - start;
+        recordResult("simulate", names[alg], n, n, elapsed);
+    }
+
+    free(jobs);
+}
+
+// Macro: the embeddable core driven through its public API, as the scheduler
+// binary does: advance to each timer the core reports before the next
+// arrival, then move to the arrival and submit the job, so it comes before
+// the timers falling due at the same instant. One call is one submit, one
+// time change or one advance.
+void benchCore(int n) {
+    Process* jobs = generateTrace(n);
+    const char* names[] = { "", "hpf", "srtn", "rr" };
+
+    for (int alg = HPF; alg <= RR; alg++) {
+        SchedCore* core = schedCreate(alg, 2);
+        long calls = 0;
+        SchedDispatch dispatch;
+        double start = nowNs();
+        for (int i = 0; i <= n; i++) {
+            // Past the last job, run the core until nothing is pending
+            int arrival = i < n ? jobs[i].arrival_time : INT_MAX;
+            schedNextDispatch(core, &dispatch);
+            while (dispatch.next_event != -1 && dispatch.next_event < arrival) {
+                schedAdvance(core, dispatch.next_event);
+                calls++;
+                schedNextDispatch(core, &dispatch);
+            }
+            if (i == n) break;
+
+            SchedJob job = { jobs[i].id, jobs[i].priority, jobs[i].runtime, 0, { 0 } };
+            schedSetTime(core, arrival);
+            schedSubmit(core, &job);
+            calls += 2;
+        }
+        double elapsed = nowNs() - start;
+
+        SchedCoreStats stats;
+        schedGetStats(core, &stats);
+        if (stats.finished != n) {
+            printf("core %s finished %d of %d jobs\n", names[alg], stats.finished, n);
+        }
+        recordResult("core_api", names[alg], n, calls, elapsed);
+        schedDestroy(core);
+    }
+
+    free(jobs);
+}
+
+// Function to replay jobs on one core directly, without sim.c's segments, as
+// the reference a parallel replay must reproduce
+void replayOnCore(const Process* jobs, int n, int alg, int quantum, SimResult* result) {
+    SchedCore* core = schedCreate(alg, quantum);
+    schedStartClock(core, jobs[0].arrival_time);
+    SchedDispatch dispatch;
+    for (int i = 0; i <= n; i++) {
+        int arrival = i < n ? jobs[i].arrival_time : INT_MAX;
+        schedNextDispatch(core, &dispatch);
+        while (dispatch.next_event != -1 && dispatch.next_event < arrival) {
+            schedAdvance(core, dispatch.next_event);
+            schedNextDispatch(core, &dispatch);
+        }
+        if (i == n) break;
+
+        SchedJob job = { jobs[i].id, jobs[i].priority, jobs[i].runtime, 0, { 0 } };
+        schedSetTime(core, arrival);
+        schedSubmit(core, &job);
+    }
+
+    SchedCoreStats stats;
+    schedGetStats(core, &stats);
+    memset(result, 0, sizeof(SimResult));
+    result->makespan = core->now;
+    result->busy_time = core->total_runtime - core->idle_time;
+    result->dispatches = core->dispatches;
+    result->preemptions = core->preemptions;
+    result->avg_wta = stats.avg_wta;
+    result->avg_waiting = stats.avg_waiting;
+    schedDestroy(core);
+}
+
+// Function to tell whether a replay matches the reference replay on one core
+bool sameReplay(const SimResult* sim, const SimResult* reference) {
+    return sim->makespan == reference->makespan && sim->busy_time == reference->busy_time &&
+           sim->dispatches == reference->dispatches && sim->preemptions == reference->preemptions &&
+           sim->avg_wta == reference->avg_wta && sim->avg_waiting == reference->avg_waiting;
+}
+
+// Macro: parallel replay on 1, 2, 4 and 8 host threads. Every thread count must
+// reproduce the single-thread result exactly, and that result must be the one
+// a single core gives replaying the whole trace; returns the number of
+// mismatches.
+int benchParallelSimulation(int n) {
+    Process* jobs = generateTrace(n);
+    const char* names[] = { "", "hpf", "srtn", "rr" };
+    int thread_counts[] = { 1, 2, 4, 8 };
+    int mismatches = 0;
+
+    for (int alg = HPF; alg <= RR; alg++) {
+        SimResult reference;
+        replayOnCore(jobs, n, alg, 2, &reference);
+
+        SimResult serial;
+        double serial_ns = 0;
+        for (int t = 0; t < 4; t++) {
+            SimResult sim;
+            double start = nowNs();
+            simulateTraceParallel(jobs, n, alg, 2, thread_counts[t], &sim);
+            double elapsed = nowNs() - start;
+
+            char variant[16];
+            snprintf(variant, sizeof(variant), "%s_t%d", names[alg], thread_counts[t]);
+            recordResult("simulate_par", variant, n, n, elapsed);
+
+            if (t == 0) {
+                serial = sim;
+                serial_ns = elapsed;
+                bool same = sameReplay(&sim, &reference);
+                if (!same) mismatches++;
+                printf("  %s on 1 thread: %d segments%s\n", names[alg], sim.segments,
+                       same ? ", same as one core" : "  MISMATCH with one core");
+                continue;
+            }
+            bool same = memcmp(&sim, &serial, sizeof(SimResult)) == 0;
+            if (!same) mismatches++;
+            printf("  %s with %d threads: speedup %.2fx over %d segments%s\n", names[alg],
+                   thread_counts[t], serial_ns / elapsed, sim.segments, same ? "" : "  MISMATCH");
+        }
+    }
+
+    free(jobs);
+    return mismatches;
+}
+
+// Function to write all results as CSV
+int writeResults(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        perror("Error opening results file");
+        return -1;
+    }
+
+    fprintf(file, "benchmark,variant,size,ops,ns_per_op,total_ms\n");
+    for (int i = 0; i < result_count; i++) {
+        fprintf(file, "%s,%s,%d,%ld,%.3f,%.3f\n", results[i].name, results[i].variant,
+                results[i].size, results[i].ops, results[i].ns_per_op, results[i].total_ms);
+    }
+
+    fclose(file);
+    return 0;
+}
+
+// Function to compare results with a baseline CSV, returning the number of regressions
+int compareWithBaseline(const char* path, double threshold) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        perror("Error opening baseline file");
+        return -1;
+    }
+
+    char line[256];
+    int regressions = 0;
+    printf("\nComparison with %s (threshold %.0f%%):\n", path, threshold);
+    while (fgets(line, sizeof(line), file)) {
+        BenchResult base;
+        if (sscanf(line, "%31[^,],%15[^,],%d,%ld,%lf,%lf", base.name, base.variant,
+                   &base.size, &base.ops, &base.ns_per_op, &base.total_ms) != 6) {
+            continue;
+        }
+
+        for (int i = 0; i < result_count; i++) {
+            if (strcmp(results[i].name, base.name) != 0 ||
+                strcmp(results[i].variant, base.variant) != 0 ||
+                results[i].size != base.size) {
+                continue;
+            }
+
+            double change = 100.0 * (results[i].ns_per_op - base.ns_per_op) / base.ns_per_op;
+            bool regressed = change > threshold;
+            if (regressed) regressions++;
+            printf("  %-14s %-8s %8d %+7.1f%%%s\n", base.name, base.variant, base.size,
+                   change, regressed ? "  REGRESSION" : "");
+        }
+    }
+
+    fclose(file);
+    return regressions;
+}
+
+int main(int argc, char *argv[]) {
+    const char* output = "bench.csv";
+    const char* baseline = NULL;
+    double threshold = 10;
+    bool quick = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "o:b:t:q")) != -1) {
+        if (opt == 'o') {
+            output = optarg;
+        } else if (opt == 'b') {
+            baseline = optarg;
+        } else if (opt == 't') {
+            threshold = atof(optarg);
+        } else if (opt == 'q') {
+            quick = true;
+        } else {
+            printf("Usage: %s [-o results.csv] [-b baseline.csv] [-t threshold%%] [-q]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    // Quick mode skips the million-entry sizes
+    int sizes[] = { 1000, 100000, 1000000 };
+    int size_count = quick ? 2 : 3;
+
+    for (int i = 0; i < size_count; i++) benchHeap(sizes[i]);
+    for (int i = 0; i < size_count; i++) benchCircularQueue(sizes[i]);
+    for (int i = 0; i < size_count; i++) benchTableScan(sizes[i]);
+    for (int i = 0; i < size_count; i++) benchLottery(sizes[i]);
+    for (int i = 0; i < size_count; i++) benchTimerWheel(sizes[i]);
+    benchMessageLatency(quick ? 10000 : 100000);
+    for (int i = 0; i < size_count; i++) benchSimulation(sizes[i]);
+    for (int i = 0; i < size_count; i++) benchCore(sizes[i]);
+    int mismatches = benchParallelSimulation(sizes[size_count - 1]);
+
+    if (writeResults(output) == -1) exit(1);
+    printf("Results written to %s\n", output);
+
+    if (mismatches > 0) {
+        printf("%d parallel replay(s) differ from a replay on one core\n", mismatches);
+        exit(1);
+    }
+
+    if (baseline != NULL) {
+        int regressions = compareWithBaseline(baseline, threshold);
+        if (regressions == -1) exit(1);
+        if (regressions > 0) {
+            printf("%d regression(s) found\n", regressions);
+            exit(1);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "headers.h"
+
+// Scheduler snapshots. A snapshot is written to a temporary file and renamed
+// over the previous one, so a crash while writing never leaves a torn file.
+
+// Function to write one array section, returning -1 on a short write
+int writeSection(FILE* file, const void* data, size_t size, int count) {
+    if (count == 0) return 0;
+    return fwrite(data, size, count, file) == (size_t)count ? 0 : -1;
+}
+
+// Function to read one freshly allocated array section, returning -1 on a short read
+int readSection(FILE* file, void** data, size_t size, int count) {
+    *data = malloc(size * (count > 0 ? count : 1));
+    if (count == 0) return 0;
+    return fread(*data, size, count, file) == (size_t)count ? 0 : -1;
+}
+
+// Function to write a snapshot atomically
+int saveCheckpoint(const char* path, const Checkpoint* checkpoint) {
+    char tmp_path[PATH_MAX];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    FILE* file = fopen(tmp_path, "wb");
+    if (!file) {
+        perror("Error opening checkpoint file");
+        return -1;
+    }
+
+    const CheckpointHeader* header = &checkpoint->header;
+    int result = 0;
+    result |= writeSection(file, header, sizeof(CheckpointHeader), 1);
+    result |= writeSection(file, checkpoint->records, sizeof(Process), header->process_count);
+    result |= writeSection(file, checkpoint->ready_order, sizeof(int), header->ready_count);
+    result |= writeSection(file, checkpoint->io_order, sizeof(int), header->io_count);
+    result |= writeSection(file, checkpoint->turnaround, sizeof(double), header->finished_count);
+    result |= writeSection(file, checkpoint->weighted_turnaround, sizeof(double), header->finished_count);
+    result |= writeSection(file, checkpoint->commands, 1, header->command_bytes);
+    result |= writeSection(file, checkpoint->usage, sizeof(RealUsage), header->process_count);
+    result |= writeSection(file, checkpoint->groups, sizeof(SchedGroup), header->group_count);
+    result |= writeSection(file, checkpoint->quantum_samples, sizeof(QuantumSample), header->quantum_sample_count);
+
+    if (fclose(file) != 0 || result != 0 || rename(tmp_path, path) == -1) {
+        perror("Error writing checkpoint");
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+// Function to read only the header of a snapshot
+int readCheckpointHeader(const char* path, CheckpointHeader* header) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        perror("Error opening checkpoint file");
+        return -1;
+    }
+
+    int ok = fread(header, sizeof(CheckpointHeader), 1, file) == 1 &&
+             header->magic == CHECKPOINT_MAGIC && header->version == CHECKPOINT_VERSION;
+    fclose(file);
+    if (!ok) {
+        printf("Error: %s is not a scheduler checkpoint\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// Function to read a whole snapshot; the arrays are released with freeCheckpoint()
+int loadCheckpoint(const char* path, Checkpoint* checkpoint) {
+    memset(checkpoint, 0, sizeof(Checkpoint));
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        perror("Error opening checkpoint file");
+        return -1;
+    }
+
+    CheckpointHeader* header = &checkpoint->header;
+    int result = fread(header, sizeof(CheckpointHeader), 1, file) == 1 &&
+                 header->magic == CHECKPOINT_MAGIC && header->version == CHECKPOINT_VERSION ? 0 : -1;
+    if (result == 0) {
+        result |= readSection(file, (void**)&checkpoint->records, sizeof(Process), header->process_count);
+        result |= readSection(file, (void**)&checkpoint->ready_order, sizeof(int), header->ready_count);
+        result |= readSection(file, (void**)&checkpoint->io_order, sizeof(int), header->io_count);
+        result |= readSection(file, (void**)&checkpoint->turnaround, sizeof(double), header->finished_count);
+        result |= readSection(file, (void**)&checkpoint->weighted_turnaround, sizeof(double),
+                              header->finished_count);
+        result |= readSection(file, (void**)&checkpoint->commands, 1, header->command_bytes);
+        result |= readSection(file, (void**)&checkpoint->usage, sizeof(RealUsage), header->process_count);
+        result |= readSection(file, (void**)&checkpoint->groups, sizeof(SchedGroup), header->group_count);
+        result |= readSection(file, (void**)&checkpoint->quantum_samples, sizeof(QuantumSample),
+                              header->quantum_sample_count);
+    }
+    fclose(file);
+
+    if (result != 0) {
+        printf("Error: %s is not a complete scheduler checkpoint\n", path);
+        freeCheckpoint(checkpoint);
+        return -1;
+    }
+    return 0;
+}
+
+// Function to release the arrays of a loaded snapshot
+void freeCheckpoint(Checkpoint* checkpoint) {
+    free(checkpoint->records);
+    free(checkpoint->ready_order);
+    free(checkpoint->io_order);
+    free(checkpoint->turnaround);
+    free(checkpoint->weighted_turnaround);
+    free(checkpoint->commands);
+    free(checkpoint->usage);
+    free(checkpoint->groups);
+    free(checkpoint->quantum_samples);
+    memset(checkpoint, 0, sizeof(Checkpoint));
+}
@@ -3,14 +3,13 @@
 int shm_id;
 SharedClock *shm_clock;
 
-int main() {
+int main(int argc, char *argv[]) {
     // Attach to shared memory
-    key_t key = ftok("keyfile", 'C');
-    shm_id = shmget(key, sizeof(SharedClock), 0666);
+    shm_id = getIpcId(ENV_CLOCK_SHM);
     shm_clock = (SharedClock *)shmat(shm_id, NULL, 0);
     
-    // Initialize clock
-    shm_clock->current_time = 0;
+    // Initialize clock; a resumed run starts from its checkpoint time
+    shm_clock->current_time = argc > 1 ? atoi(argv[1]) : 0;
     
     // Increment clock every second
     while (1) {
@@ -5,7 +5,7 @@ CircularQueue* createCircularQueue(int capacity) {
     CircularQueue* queue = (CircularQueue*)malloc(sizeof(CircularQueue));
     queue->capacity = capacity;
     queue->front = queue->rear = queue->size = 0;
-    queue->array = (Process*)malloc(capacity * sizeof(Process));
+    queue->array = (int*)malloc(capacity * sizeof(int));
     return queue;
 }
 
@@ -17,26 +17,118 @@ int isCircularQueueEmpty(CircularQueue* queue) {
     return queue->size == 0;
 }
 
-void enqueueCircularQueue(CircularQueue* queue, Process process) {
+void enqueueCircularQueue(CircularQueue* queue, int index) {
     if (isCircularQueueFull(queue)) {
-        printf("Circular Queue Overflow\n");
-        return;
+        // Grow and unwrap so the elements stay in FIFO order
+        int capacity = queue->capacity * 2;
+        int* array = (int*)malloc(capacity * sizeof(int));
+        for (int i = 0; i < queue->size; i++) {
+            array[i] = queue->array[(queue->front + i) % queue->capacity];
+        }
+        free(queue->array);
+        queue->array = array;
+        queue->capacity = capacity;
+        queue->front = 0;
+        queue->rear = queue->size;
     }
-    queue->array[queue->rear] = process;
+    queue->array[queue->rear] = index;
     queue->rear = (queue->rear + 1) % queue->capacity;
     queue->size++;
 }
 
-Process dequeueCircularQueue(CircularQueue* queue) {
+int dequeueCircularQueue(CircularQueue* queue) {
     if (isCircularQueueEmpty(queue)) {
         printf("Circular Queue Underflow\n");
-        Process dummy = { -1, -1, -1, -1 };
-        return dummy;
+        return -1;
     }
-    Process process = queue->array[queue->front];
+    int index = queue->array[queue->front];
     queue->front = (queue->front + 1) % queue->capacity;
     queue->size--;
-    return process;
+    return index;
+}
+
+// Function to append the table indices of the queued processes, front first
+int collectCircularQueue(const CircularQueue* queue, int* order) {
+    for (int i = 0; i < queue->size; i++) {
+        order[i] = queue->array[(queue->front + i) % queue->capacity];
+    }
+    return queue->size;
+}
+
+void destroyCircularQueue(CircularQueue* queue) {
+    free(queue->array);
+    free(queue);
+}
+
+// Process Table Functions
+ProcessTable* createProcessTable(int capacity) {
+    ProcessTable* table = (ProcessTable*)calloc(1, sizeof(ProcessTable));
+    table->capacity = capacity;
+    table->state = (unsigned char*)malloc(capacity * sizeof(unsigned char));
+    table->pid = (int*)malloc(capacity * sizeof(int));
+    table->records = (Process*)malloc(capacity * sizeof(Process));
+    return table;
+}
+
+// Function to append a process, returning its index
+int addProcessToTable(ProcessTable* table, Process process) {
+    if (table->count == table->capacity) {
+        table->capacity *= 2;
+        table->state = (unsigned char*)realloc(table->state, table->capacity * sizeof(unsigned char));
+        table->pid = (int*)realloc(table->pid, table->capacity * sizeof(int));
+        table->records = (Process*)realloc(table->records, table->capacity * sizeof(Process));
+    }
+
+    int index = table->count++;
+    process.table_index = index;
+    table->records[index] = process;
+    table->state[index] = (unsigned char)process.state;
+    table->pid[index] = process.pid;
+    table->state_count[process.state]++;
+    return index;
+}
+
+void setProcessState(ProcessTable* table, int index, int state) {
+    table->state_count[table->state[index]]--;
+    table->state_count[state]++;
+    table->state[index] = (unsigned char)state;
+    table->records[index].state = state;
+}
+
+void setProcessPid(ProcessTable* table, int index, int pid) {
+    table->pid[index] = pid;
+    table->records[index].pid = pid;
+}
+
+// Function to find the unfinished process with the given pid, or -1. Both waitpid()
+// and the termination message report a process, so finished ones are skipped.
+int findProcessByPid(const ProcessTable* table, int pid) {
+    const int* pids = table->pid;
+    for (int i = 0; i < table->count; i++) {
+        if (pids[i] == pid && table->state[i] != FINISHED) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Function to count processes in a state by scanning the byte column (vectorizes)
+int countProcessesInState(const ProcessTable* table, int state) {
+    const unsigned char* column = table->state;
+    int count = 0;
+    for (int i = 0; i < table->count; i++) {
+        count += column[i] == state;
+    }
+    return count;
+}
+
+void destroyProcessTable(ProcessTable* table) {
+    if (table != NULL) {
+        free(table->state);
+        free(table->pid);
+        free(table->records);
+        free(table);
+    }
 }
 
 // Priority Queue Functions
@@ -44,68 +136,27 @@ PriorityQueue* createPriorityQueue(int capacity) {
     PriorityQueue* pq = (PriorityQueue*)malloc(sizeof(PriorityQueue));
     pq->capacity = capacity;
     pq->size = 0;
-    pq->array = (Process*)malloc(capacity * sizeof(Process));
+    pq->array = (QueueEntry*)malloc(capacity * sizeof(QueueEntry));
     return pq;
 }
 
-void swapProcesses(Process* a, Process* b) {
-    Process temp = *a;
+void swapEntries(QueueEntry* a, QueueEntry* b) {
+    QueueEntry temp = *a;
     *a = *b;
     *b = temp;
 }
 
-// Modified heapify functions to consider arrival time
-void heapifyUpPriority(PriorityQueue* pq, int index) {
-    while (index > 0) {
-        int parent = (index - 1) / 2;
-        // Compare priority first
-        if (pq->array[index].priority < pq->array[parent].priority ||
-            // If priorities are equal, compare arrival times
-            (pq->array[index].priority == pq->array[parent].priority &&
-                pq->array[index].arrival_time < pq->array[parent].arrival_time)) {
-            swapProcesses(&pq->array[index], &pq->array[parent]);
-            index = parent;
-        }
-        else {
-            break;
-        }
-    }
-}
-
-void heapifyDownPriority(PriorityQueue* pq, int index) {
-    int smallest = index;
-    int left = 2 * index + 1;
-    int right = 2 * index + 2;
-
-    // Check left child
-    if (left < pq->size &&
-        (pq->array[left].priority < pq->array[smallest].priority ||
-            (pq->array[left].priority == pq->array[smallest].priority &&
-                pq->array[left].arrival_time < pq->array[smallest].arrival_time)))
-        smallest = left;
-
-    // Check right child
-    if (right < pq->size &&
-        (pq->array[right].priority < pq->array[smallest].priority ||
-            (pq->array[right].priority == pq->array[smallest].priority &&
-                pq->array[right].arrival_time < pq->array[smallest].arrival_time)))
-        smallest = right;
-
-    if (smallest != index) {
-        swapProcesses(&pq->array[index], &pq->array[smallest]);
-        heapifyDownPriority(pq, smallest);
-    }
+// Function to tell whether entry a goes before entry b: smaller key first,
+// ties broken by arrival time
+static bool entryBefore(const QueueEntry* a, const QueueEntry* b) {
+    return a->key < b->key || (a->key == b->key && a->arrival_time < b->arrival_time);
 }
 
-void heapifyUpRuntime(PriorityQueue* pq, int index) {
+void heapifyUp(PriorityQueue* pq, int index) {
     while (index > 0) {
         int parent = (index - 1) / 2;
-        // Compare runtime first
-        if (pq->array[index].remaining_time < pq->array[parent].remaining_time ||
-            // If runtimes are equal, compare arrival times
-            (pq->array[index].remaining_time == pq->array[parent].remaining_time &&
-                pq->array[index].arrival_time < pq->array[parent].arrival_time)) {
-            swapProcesses(&pq->array[index], &pq->array[parent]);
+        if (entryBefore(&pq->array[index], &pq->array[parent])) {
+            swapEntries(&pq->array[index], &pq->array[parent]);
             index = parent;
         }
         else {
@@ -114,73 +165,56 @@ void heapifyUpRuntime(PriorityQueue* pq, int index) {
     }
 }
 
-void heapifyDownRuntime(PriorityQueue* pq, int index) {
+void heapifyDown(PriorityQueue* pq, int index) {
     int smallest = index;
     int left = 2 * index + 1;
     int right = 2 * index + 2;
 
     // Check left child
-    if (left < pq->size &&
-        (pq->array[left].remaining_time < pq->array[smallest].remaining_time ||
-            (pq->array[left].remaining_time == pq->array[smallest].remaining_time &&
-                pq->array[left].arrival_time < pq->array[smallest].arrival_time)))
+    if (left < pq->size && entryBefore(&pq->array[left], &pq->array[smallest]))
         smallest = left;
 
     // Check right child
-    if (right < pq->size &&
-        (pq->array[right].remaining_time < pq->array[smallest].remaining_time ||
-            (pq->array[right].remaining_time == pq->array[smallest].remaining_time &&
-                pq->array[right].arrival_time < pq->array[smallest].arrival_time)))
+    if (right < pq->size && entryBefore(&pq->array[right], &pq->array[smallest]))
         smallest = right;
 
     if (smallest != index) {
-        swapProcesses(&pq->array[index], &pq->array[smallest]);
-        heapifyDownRuntime(pq, smallest);
+        swapEntries(&pq->array[index], &pq->array[smallest]);
+        heapifyDown(pq, smallest);
     }
 }
 
-void insertPriorityPriorityQueue(PriorityQueue* pq, Process process) {
+// Function to queue a process under the given key. The key is copied at
+// insert time, so a process must be removed and inserted again to move it.
+void insertPriorityQueue(PriorityQueue* pq, long key, const Process* process) {
     if (pq->size == pq->capacity) {
-        printf("Priority Queue Overflow\n");
-        return;
+        pq->capacity *= 2;
+        pq->array = (QueueEntry*)realloc(pq->array, pq->capacity * sizeof(QueueEntry));
     }
-    pq->array[pq->size] = process;
-    heapifyUpPriority(pq, pq->size);
+    QueueEntry entry = { key, process->arrival_time, process->table_index };
+    pq->array[pq->size] = entry;
+    heapifyUp(pq, pq->size);
     pq->size++;
 }
 
-void insertRuntimePriorityQueue(PriorityQueue* pq, Process process) {
-    if (pq->size == pq->capacity) {
-        printf("Priority Queue Overflow\n");
-        return;
-    }
-    pq->array[pq->size] = process;
-    heapifyUpRuntime(pq, pq->size);
-    pq->size++;
-}
-
-Process removePriorityPriorityQueue(PriorityQueue* pq) {
+QueueEntry removePriorityQueue(PriorityQueue* pq) {
     if (pq->size == 0) {
         printf("Priority Queue Underflow\n");
-        Process dummy = { -1, -1, -1, -1 };
+        QueueEntry dummy = { -1, -1, -1 };
         return dummy;
     }
-    Process root = pq->array[0];
+    QueueEntry root = pq->array[0];
     pq->array[0] = pq->array[--pq->size];
-    heapifyDownPriority(pq, 0);
+    heapifyDown(pq, 0);
     return root;
 }
 
-Process removeRuntimePriorityQueue(PriorityQueue* pq) {
-    if (pq->size == 0) {
-        printf("Priority Queue Underflow\n");
-        Process dummy = { -1, -1, -1, -1 };
-        return dummy;
+// Function to append the table indices of the queued processes in heap order
+int collectPriorityQueue(const PriorityQueue* pq, int* order) {
+    for (int i = 0; i < pq->size; i++) {
+        order[i] = pq->array[i].table_index;
     }
-    Process root = pq->array[0];
-    pq->array[0] = pq->array[--pq->size];
-    heapifyDownRuntime(pq, 0);
-    return root;
+    return pq->size;
 }
 
 void destroyPriorityQueue(PriorityQueue* pq) {
@@ -189,3 +223,68 @@ void destroyPriorityQueue(PriorityQueue* pq) {
         free(pq);
     }
 }
+
+// Lottery Tree Implementation
+LotteryTree* createLotteryTree(int capacity) {
+    LotteryTree* lottery = (LotteryTree*)malloc(sizeof(LotteryTree));
+    lottery->capacity = 1;
+    while (lottery->capacity < capacity) lottery->capacity *= 2;
+    lottery->tree = (long*)calloc(lottery->capacity + 1, sizeof(long));
+    lottery->tickets = (int*)calloc(lottery->capacity, sizeof(int));
+    lottery->total = 0;
+    lottery->size = 0;
+    return lottery;
+}
+
+// Function to double the slot count until slot fits, rebuilding the tree in O(n)
+void growLotteryTree(LotteryTree* lottery, int slot) {
+    int old_capacity = lottery->capacity;
+    while (lottery->capacity <= slot) lottery->capacity *= 2;
+
+    lottery->tickets = (int*)realloc(lottery->tickets, lottery->capacity * sizeof(int));
+    memset(lottery->tickets + old_capacity, 0, (lottery->capacity - old_capacity) * sizeof(int));
+
+    free(lottery->tree);
+    lottery->tree = (long*)calloc(lottery->capacity + 1, sizeof(long));
+    for (int i = 1; i <= lottery->capacity; i++) {
+        lottery->tree[i] += lottery->tickets[i - 1];
+        int parent = i + (i & -i);
+        if (parent <= lottery->capacity) lottery->tree[parent] += lottery->tree[i];
+    }
+}
+
+// Function to set the tickets a slot holds in the draw; 0 takes it out
+void setLotteryTickets(LotteryTree* lottery, int slot, int tickets) {
+    if (slot >= lottery->capacity) growLotteryTree(lottery, slot);
+
+    int delta = tickets - lottery->tickets[slot];
+    if (delta == 0) return;
+
+    if (lottery->tickets[slot] == 0) lottery->size++;
+    if (tickets == 0) lottery->size--;
+    lottery->tickets[slot] = tickets;
+    lottery->total += delta;
+    for (int i = slot + 1; i <= lottery->capacity; i += i & -i) {
+        lottery->tree[i] += delta;
+    }
+}
+
+// Function to find the slot holding the given winning ticket (0 <= ticket < total)
+int drawLotteryTree(const LotteryTree* lottery, long ticket) {
+    int position = 0;
+    for (int step = lottery->capacity; step > 0; step >>= 1) {
+        if (position + step <= lottery->capacity && lottery->tree[position + step] <= ticket) {
+            position += step;
+            ticket -= lottery->tree[position];
+        }
+    }
+    return position;
+}
+
+void destroyLotteryTree(LotteryTree* lottery) {
+    if (lottery != NULL) {
+        free(lottery->tree);
+        free(lottery->tickets);
+        free(lottery);
+    }
+}
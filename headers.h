@@ -15,22 +15,86 @@
 #include <sys/wait.h>
 #include <limits.h>
 #include <stdbool.h>
+#include "schedcore.h"
 
 // Define process states
 #define READY 0
 #define RUNNING 1
 #define STOPPED 2
 #define FINISHED 3
+#define BLOCKED 4    // Waiting for an I/O burst to complete
+#define PENDING 5    // Waiting for the jobs it depends on to finish
+#define STATE_COUNT 6
 
 // Define message types
 #define PROCESS_ARRIVAL 1
 #define PROCESS_TERMINATION 2
 #define CLOCK_TICK 3
+#define GENERATOR_DONE 4
+#define ARRIVAL_ACK 5        // Scheduler returns window credits to the generator
+#define PROCESS_BATCH 6      // Several arrivals coalesced into one message
 
-// Define scheduling algorithms
-#define HPF 1
-#define SRTN 2
-#define RR 3
+// Flow control: the generator keeps at most a window of arrival messages in
+// the queue and gets credits back as the scheduler consumes them. When the
+// window is full it blocks, drops the job or coalesces it with later ones.
+#define OVERFLOW_BLOCK 0
+#define OVERFLOW_DROP 1
+#define OVERFLOW_COALESCE 2
+#define OVERFLOW_NAMES { "block", "drop", "coalesce" }
+#define ARRIVAL_BATCH 4      // Jobs per coalesced message
+#define LATENESS_BUCKETS 5   // Delivered on time, 1, 2-3, 4-7 and 8+ ticks late
+
+// Environment variables carrying the IPC identifiers of one simulation instance
+#define ENV_CLOCK_SHM "SCHED_CLOCK_SHM"
+#define ENV_MSGQ "SCHED_MSGQ"
+#define ENV_STATS_SHM "SCHED_STATS_SHM"
+#define INSTANCE_FILE "instance.ipc"
+
+// Checkpointing: ENV_CHECKPOINT_EVERY is the snapshot interval in clock ticks,
+// ENV_RESTORE names a snapshot the scheduler resumes from
+#define ENV_CHECKPOINT_EVERY "SCHED_CHECKPOINT_EVERY"
+#define ENV_RESTORE "SCHED_RESTORE"
+#define CHECKPOINT_FILE "scheduler.ckpt"
+#define CHECKPOINT_MAGIC 0x504b4353 // "SCKP"
+#define CHECKPOINT_VERSION 11
+
+// Real jobs: a trace line may end in "cmd=<command line>", which the scheduler
+// runs with /bin/sh instead of ./process. ENV_REAL_CPU pins them to one CPU.
+#define MAX_COMMAND 256
+#define ENV_REAL_CPU "SCHED_REAL_CPU"
+
+// Trace event types are defined in schedcore.h
+#define TRACE_FILE "scheduler.trace"
+#define TRACE_MAGIC 0x43525453 // "STRC"
+
+// Scheduler binaries specialized for a single policy (see the Makefile),
+// indexed by algorithm
+#define ENGINE_NAMES { "", "scheduler-hpf", "scheduler-srtn", "scheduler-rr", \
+                       "scheduler-lottery", "scheduler-stride", "scheduler-psrtn", \
+                       "scheduler-fairhpf", "scheduler-fairsrtn", "scheduler-fairrr", "scheduler-cp" }
+
+// Algorithms that preempt the running process after a time quantum
+#define USES_QUANTUM(alg) ((alg) == RR || (alg) == LOTTERY || (alg) == STRIDE || \
+                           (alg) == FAIR_HPF || (alg) == FAIR_SRTN || (alg) == FAIR_RR)
+
+// Algorithms that run the shortest job first and preempt on arrival
+#define SHORTEST_FIRST(alg) ((alg) == SRTN || (alg) == PSRTN)
+
+// PSRTN predicts each CPU burst as an exponential average of the bursts seen
+// from the same priority class: next = alpha * last + (1 - alpha) * previous
+#define PREDICTION_ALPHA 0.5
+
+// The adaptive quantum (see sliceLength) is derived from the last
+// QUANTUM_WINDOW CPU bursts that completed and from the ready queue length.
+// ENV_QUANTUM_PERCENTILE overrides the burst percentile.
+#define QUANTUM_WINDOW 32
+#define DEFAULT_QUANTUM_PERCENTILE 50
+#define ENV_QUANTUM_PERCENTILE "SCHED_QUANTUM_PERCENTILE"
+
+// Proportional share: priority 0 (highest) gets MAX_PRIORITY + 1 ticket
+// levels, priority MAX_PRIORITY gets one
+#define TICKETS_PER_LEVEL 100
+#define STRIDE_ONE (1L << 20) // Stride of a process holding a single ticket
 
 // Process structure as provided
 typedef struct Process {
@@ -48,69 +112,583 @@ typedef struct Process {
     int finish_time;
     int state;
     int last_run_time;
+    int ready_since; // Time the process entered a ready queue, -1 otherwise
     int pid; // Actual process ID
+    int table_index; // Slot in the scheduler's process table, -1 before arrival
+    bool open_ended; // Runtime is only an estimate; the job itself says when a burst ends
+    
+    // Burst profile; a CPU-only job has a single burst equal to its runtime
+    int bursts[MAX_BURSTS];
+    int burst_count;
+    int burst_index;     // Burst the process is currently in
+    int burst_remaining; // CPU time left in the current CPU burst
+    
+    // Proportional-share bookkeeping (LOTTERY and STRIDE)
+    int tickets;
+    long pass;              // Stride scheduling virtual time
+    double share_mark;      // Per-ticket clock when the process last became runnable
+    double entitled_time;   // CPU time its ticket share entitled it to so far
+    
+    // Burst prediction (PSRTN)
+    int predicted_burst;    // Prediction made when the current CPU burst began
+    int estimate;           // Predicted CPU time left in the current burst
+    
+    // Owner, from the optional "group=name:weight" field
+    char group_name[MAX_GROUP_NAME];
+    int group_weight;
+    int group;              // Slot in the core's group table, set on admission
+    
+    // Dependencies, from the optional "deps=id,id,..." field
+    int deps[MAX_DEPS];
+    int dep_count;
+    int indegree;           // Parents that have not finished yet
+    int critical_path;      // Longest path (CPU and I/O) from the job to the end of its DAG
 } Process;
 
-// Circular Queue Implementation
+// Process table split by access pattern. The state and pid columns are dense
+// arrays scanned on every tick or termination; the full records are only
+// touched when a process changes state. Columns mirror the record fields and
+// are written only through setProcessState()/setProcessPid().
+typedef struct ProcessTable {
+    int count;
+    int capacity;
+    unsigned char* state;       // Hot column, one byte per process
+    int* pid;                   // Hot column
+    Process* records;           // Cold records
+    int state_count[STATE_COUNT];
+} ProcessTable;
+
+// Circular Queue Implementation, holding process table indices
 typedef struct CircularQueue {
     int front, rear, size;
     int capacity;
-    Process* array;
+    int* array;
 } CircularQueue;
 
-// Priority Queue Implementation
+// Priority Queue entry: the process's table index with the key it was queued
+// under, so heap moves shuffle 16 bytes instead of whole records
+typedef struct QueueEntry {
+    long key;
+    int arrival_time;   // Breaks ties between equal keys
+    int table_index;
+} QueueEntry;
+
+// Priority Queue Implementation, smallest key first
 typedef struct PriorityQueue {
-    Process* array;
+    QueueEntry* array;
     int size;
     int capacity;
 } PriorityQueue;
 
+// Ticket totals over process table slots (a Fenwick tree), so a lottery draw
+// and a ticket change are both O(log n)
+typedef struct LotteryTree {
+    int capacity;     // Number of slots, always a power of two
+    long* tree;       // Fenwick tree, 1-based
+    int* tickets;     // Tickets per slot, 0 when the slot is not in the draw
+    long total;
+    int size;         // Slots currently in the draw
+} LotteryTree;
+
+// Flow-control counters of the generator, sent along with GENERATOR_DONE
+typedef struct {
+    int window;           // Arrival messages allowed in the queue at once
+    int overflow;         // OVERFLOW_ policy applied when the window is full
+    int sent;             // Arrival messages sent, batches included
+    int dropped;          // Jobs never delivered (OVERFLOW_DROP)
+    int coalesced;        // Jobs delivered in a PROCESS_BATCH
+    int stalls;           // Times the generator waited for a credit
+    long long stall_ns;   // Time spent waiting for credits
+} FlowCounters;
+
 // Message structure for IPC
 typedef struct {
     long mtype;
     Process process;
+    long long sent_ns; // Monotonic send time, for delivery latency
+    int position;      // Index of the job in the generator's arrival order
+    char command[MAX_COMMAND]; // Command line of a real job, empty for simulated ones
+    FlowCounters flow; // Only filled in for GENERATOR_DONE
 } Message;
 
+// Payload size for msgsnd/msgrcv (everything after mtype)
+#define MESSAGE_SIZE (sizeof(Message) - sizeof(long))
+
+// Simulated jobs coalesced while the window was full; real jobs always travel
+// alone because only a Message carries a command line
+typedef struct {
+    long mtype;
+    long long sent_ns;
+    int position;      // Arrival-order index of the last job
+    int count;
+    Process processes[ARRIVAL_BATCH];
+} BatchMessage;
+
+#define BATCH_SIZE (sizeof(BatchMessage) - sizeof(long))
+
+// Credits returned to the generator: one per arrival message consumed
+typedef struct {
+    long mtype;
+    int credits;
+} AckMessage;
+
+#define ACK_SIZE (sizeof(AckMessage) - sizeof(long))
+
+// Log2-bucketed latency histogram; bucket i counts samples below 2^i ns
+#define LATENCY_BUCKETS 48
+
+typedef struct {
+    long count;
+    long long total_ns;
+    long long max_ns;
+    long buckets[LATENCY_BUCKETS];
+} LatencyHistogram;
+
+// Resources a real job used, as reported by wait4() when it exits
+typedef struct {
+    bool measured;
+    double cpu_time;            // User plus system time, in seconds
+    long voluntary_switches;
+    long involuntary_switches;
+    long max_rss_kb;
+} RealUsage;
+
+// A change of the adaptive quantum, for the report in scheduler.perf
+typedef struct {
+    int time;
+    int quantum;     // Burst percentile the slices are derived from
+    int ready;       // Ready queue length at the change
+} QuantumSample;
+
 // Shared memory structure for clock
 typedef struct {
-    int current_time;
+    volatile int current_time; // Written by clk, polled by everyone else
 } SharedClock;
 
+// Live statistics page published by the scheduler. Observers attach it
+// read-only and retry while seq is odd (an update is in progress).
+typedef struct {
+    volatile unsigned int seq;
+    int algorithm;
+    int quantum;
+    int current_time;
+    int process_count;
+    int finished_count;
+    int running_id;                        // -1 while the CPU is idle
+    int blocked_count;                     // Processes waiting on the I/O device
+    int queue_depth[ALGORITHM_COUNT + 1];  // Indexed by algorithm
+    long dispatches;
+    long preemptions;
+    int dispatches_per_sec;                // Dispatches during the last clock second
+    double cpu_utilization;
+    double device_utilization;
+    double avg_waiting;                    // Running averages over finished processes
+    double avg_wta;
+} SchedStats;
+
+// Header of the binary event stream in scheduler.trace
+typedef struct {
+    int magic;
+    int version;
+    int algorithm;
+    int quantum;
+} TraceHeader;
+
+// One fixed-size record of the event stream
+typedef struct {
+    int time;
+    int type;
+    int process_id;  // -1 for queue-depth samples
+    int value;       // Remaining time, or the queue depth for samples
+} TraceEvent;
+
+// A group of processes sharing a weight (see joinGroup)
+typedef struct {
+    char name[MAX_GROUP_NAME];
+    int weight;
+    long pass;              // Advances by STRIDE_ONE / weight per tick the group runs
+} SchedGroup;
+
+// Header of a scheduler snapshot. It is followed by the process records, the
+// ready queue and I/O queue as table indices in queue order, the turnaround
+// and weighted turnaround of every finished process, the command line of every
+// process (NUL-terminated, empty for simulated ones), the usage of every
+// process, the groups in the order they were created and the changes of the
+// adaptive quantum.
+typedef struct {
+    int magic;
+    int version;
+    int algorithm;
+    int quantum;
+    int time;                // Clock value the snapshot was taken at
+    int process_count;       // Processes received from the generator so far
+    int trace_position;      // Jobs of the generator's arrival order sent or dropped so far
+    int ready_count;
+    int io_count;
+    int io_index;            // Process on the I/O device, -1 if idle
+    int io_done_time;
+    long io_busy_time;
+    int total_runtime;
+    int idle_time;
+    int finished_count;
+    long dispatches;
+    long preemptions;
+    double total_finished_waiting;
+    double total_finished_wta;
+    double share_clock;
+    long active_tickets;
+    long stride_pass;
+    unsigned long long lottery_seed;
+    int group_count;
+    long group_pass;
+    double class_estimate[MAX_PRIORITY + 1];  // PSRTN burst prediction state
+    bool class_seen[MAX_PRIORITY + 1];
+    double overall_estimate;
+    bool overall_seen;
+    long prediction_count[MAX_PRIORITY + 1];
+    double prediction_abs_error[MAX_PRIORITY + 1];
+    double prediction_bias;
+    double prediction_rel_error;
+    int burst_window[QUANTUM_WINDOW];  // Adaptive quantum state
+    int burst_window_count;
+    int burst_window_next;
+    int current_quantum;
+    long slice_total;
+    long slice_count;
+    int slice_min;
+    int slice_max;
+    int quantum_sample_count;
+    int arrivals_received;   // Arrival delivery so far
+    int late_arrivals;
+    long total_lateness;
+    int max_lateness;
+    long lateness_buckets[LATENESS_BUCKETS];
+    int command_bytes;       // Size of the command line section
+} CheckpointHeader;
+
+// Snapshot contents in memory, as written by saveCheckpoint()
+typedef struct {
+    CheckpointHeader header;
+    Process* records;
+    int* ready_order;
+    int* io_order;
+    double* turnaround;
+    double* weighted_turnaround;
+    char* commands;
+    RealUsage* usage;
+    SchedGroup* groups;
+    QuantumSample* quantum_samples;
+} Checkpoint;
+
+// Timing wheel (see timer.c)
+#define TIMER_SLOT_BITS 6
+#define TIMER_SLOTS (1 << TIMER_SLOT_BITS)
+#define TIMER_LEVELS 5       // Covers 2^30 ticks ahead
+
+// Timer types
+#define TIMER_QUANTUM 1      // Time slice of the running process is used up
+#define TIMER_IO 2           // I/O device finishes its current burst
+#define TIMER_STATS 3        // Periodic state log and statistics page
+#define TIMER_CHECKPOINT 4   // Periodic snapshot
+#define TIMER_ARRIVAL 5      // Process generator releases a job
+#define TIMER_BURST 6        // Running CPU burst ends (scheduling core only)
+
+typedef struct Timer {
+    int expires;             // Clock tick the timer fires at
+    int type;
+    int data;                // Owner-defined, e.g. a table index
+    bool pending;
+    struct Timer* prev;
+    struct Timer* next;
+} Timer;
+
+typedef void (*TimerCallback)(Timer* timer);
+
+typedef struct {
+    int now;                 // Last tick the wheel was advanced to
+    int pending;
+    Timer due;               // Sentinel of timers that fire on the next advance
+    Timer slots[TIMER_LEVELS][TIMER_SLOTS]; // Sentinels of the slot lists
+} TimerWheel;
+
+// Result of a virtual-time replay of a trace (see sim.c)
+typedef struct {
+    int makespan;
+    long busy_time;
+    long dispatches;
+    long preemptions;
+    double cpu_utilization;
+    double avg_wta;
+    double avg_waiting;
+    double std_wta;
+    int segments;     // Independent busy-period segments the trace was cut into
+} SimResult;
+
+// Dependency bookkeeping of one job id (see schedcore.c). Once some job has
+// parents, a node exists for every id seen, as a job or as a parent, so a
+// parent may arrive after its children.
+typedef struct {
+    int id;                 // Job id, -1 for an empty slot of the hash
+    int index;              // Table index of the job, -1 until it arrives
+    bool finished;
+    int* children;          // Table indices of pending jobs waiting for it
+    int child_count;
+    int child_capacity;
+} DependencyNode;
+
+// A scheduling policy as seen by the scheduling core (see policy.c). Each
+// policy lives in its own policy_<name>.c module and keeps its ready queue in
+// core->policy_state; the core only calls these hooks. Hooks left NULL do
+// nothing.
+typedef struct {
+    int algorithm;                       // Number the policy is selected by
+    const char* name;
+    bool time_sliced;                    // Stops the running process when its quantum ends
+    void (*init)(SchedCore* core);
+    void (*enqueue)(SchedCore* core, Process* process); // Process became ready; it may adjust its record
+    int (*pickNext)(SchedCore* core);    // Remove and return the table index to run, -1 if none
+    bool (*preempts)(SchedCore* core, Process* running); // Whether a process just made ready displaces the running one
+    bool (*onTick)(SchedCore* core, Process* running);   // Once per clock tick while a process runs; true stops it
+    void (*onPreempt)(SchedCore* core, Process* process, int ran); // Running process gives up the CPU unfinished
+    int (*size)(SchedCore* core);
+    int (*readyOrder)(SchedCore* core, int* order);      // Table indices of the ready queue, in queue order
+    void (*logQueue)(SchedCore* core, FILE* file);
+    void (*report)(SchedCore* core, FILE* file, double avg_wta); // Policy figures for scheduler.perf
+    void (*destroy)(SchedCore* core);
+} SchedPolicy;
+
+// State of one scheduling core (see schedcore.c). The scheduler binary reads
+// it directly and writes it when restoring a snapshot; embedders only go
+// through the functions in schedcore.h.
+struct SchedCore {
+    const SchedPolicy* policy;
+    void* policy_state;          // Ready queue of the policy
+    int algorithm;
+    int quantum;
+    int now;                     // Current time, as last set by the caller
+    bool external_bursts;        // CPU bursts end when the caller says so, not by the burst timer
+    SchedEventCallback callback;
+    void* context;
+    
+    ProcessTable* table;
+    int running_index;           // -1 while the CPU is idle
+    TimerWheel* timers;
+    Timer quantum_timer;         // End of the running process's time slice
+    Timer burst_timer;           // End of the running CPU burst, unless external_bursts
+    Timer io_timer;              // Completion of the burst on the I/O device
+    
+    // Single FCFS I/O device shared by all processes
+    CircularQueue* io_queue;
+    int io_index;                // Table index of the process being served, -1 while idle
+    int io_done_time;            // Completion time of the burst being served
+    long io_busy_time;           // Device time handed out so far
+    
+    // Per-ticket virtual clock: advances by dt / active_tickets while processes are
+    // runnable, so a process's entitled CPU time is tickets * (clock - share_mark)
+    double share_clock;
+    int share_last_time;
+    long active_tickets;
+    long stride_pass;                 // Pass of the last process dispatched by STRIDE
+    unsigned long long lottery_seed;  // State of the LOTTERY draws
+    
+    // Groups in order of their first job
+    SchedGroup* groups;
+    int group_count;
+    int group_capacity;
+    long group_pass;             // Pass of the group dispatched last by the FAIR_ policies
+    
+    // Dependencies, in a hash keyed by job id; empty while no job has parents
+    DependencyNode* dep_nodes;
+    size_t dep_capacity;         // Slots, 0 or a power of two
+    size_t dep_count;            // Slots used
+    bool has_deps;               // Some job depended on another
+    
+    // Statistics
+    int total_runtime;
+    int idle_time;
+    int last_clock;
+    double* turnaround_times;
+    double* weighted_turnaround_times;
+    int finished_count;
+    long dispatches;
+    long preemptions;
+    double total_finished_waiting;
+    double total_finished_wta;
+    LatencyHistogram queue_latency;
+    
+    // Adaptive quantum (see sliceLength)
+    bool adaptive_quantum;
+    int burst_window[QUANTUM_WINDOW];  // Lengths of the CPU bursts completed most recently
+    int burst_window_count;
+    int burst_window_next;             // Slot the next completed burst goes to
+    int quantum_percentile;
+    int current_quantum;               // Quantum behind the last slice, 0 before the first
+    long slice_total;
+    long slice_count;
+    int slice_min;
+    int slice_max;
+    QuantumSample* quantum_samples;
+    int quantum_sample_count;
+    int quantum_sample_capacity;
+    
+    // Burst prediction: exponential average of the CPU bursts seen per priority
+    // class, falling back to the average over all classes for a class not seen yet
+    double class_estimate[MAX_PRIORITY + 1];
+    bool class_seen[MAX_PRIORITY + 1];
+    double overall_estimate;
+    bool overall_seen;
+    long prediction_count[MAX_PRIORITY + 1];
+    double prediction_abs_error[MAX_PRIORITY + 1];
+    double prediction_bias;            // Sum of predicted minus actual
+    double prediction_rel_error;       // Sum of |error| / actual
+};
+
 // Function declarations for Circular Queue
 CircularQueue* createCircularQueue(int capacity);
 int isCircularQueueFull(CircularQueue* queue);
 int isCircularQueueEmpty(CircularQueue* queue);
-void enqueueCircularQueue(CircularQueue* queue, Process process);
-Process dequeueCircularQueue(CircularQueue* queue);
+void enqueueCircularQueue(CircularQueue* queue, int index);
+int dequeueCircularQueue(CircularQueue* queue);
+int collectCircularQueue(const CircularQueue* queue, int* order);
+void destroyCircularQueue(CircularQueue* queue);
+
+// Function declarations for Process Table
+ProcessTable* createProcessTable(int capacity);
+int addProcessToTable(ProcessTable* table, Process process);
+void setProcessState(ProcessTable* table, int index, int state);
+void setProcessPid(ProcessTable* table, int index, int pid);
+int findProcessByPid(const ProcessTable* table, int pid);
+int countProcessesInState(const ProcessTable* table, int state);
+void destroyProcessTable(ProcessTable* table);
 
 // Function declarations for Priority Queue
 PriorityQueue* createPriorityQueue(int capacity);
-void swapProcesses(Process* a, Process* b);
-void heapifyUpPriority(PriorityQueue* pq, int index);
-void heapifyDownPriority(PriorityQueue* pq, int index);
-void heapifyUpRuntime(PriorityQueue* pq, int index);
-void heapifyDownRuntime(PriorityQueue* pq, int index);
-void insertPriorityPriorityQueue(PriorityQueue* pq, Process process);
-void insertRuntimePriorityQueue(PriorityQueue* pq, Process process);
-Process removePriorityPriorityQueue(PriorityQueue* pq);
-Process removeRuntimePriorityQueue(PriorityQueue* pq);
+void swapEntries(QueueEntry* a, QueueEntry* b);
+void heapifyUp(PriorityQueue* pq, int index);
+void heapifyDown(PriorityQueue* pq, int index);
+void insertPriorityQueue(PriorityQueue* pq, long key, const Process* process);
+QueueEntry removePriorityQueue(PriorityQueue* pq);
+int collectPriorityQueue(const PriorityQueue* pq, int* order);
 void destroyPriorityQueue(PriorityQueue* pq);
 
+// Function declarations for the lottery tree
+LotteryTree* createLotteryTree(int capacity);
+void setLotteryTickets(LotteryTree* lottery, int slot, int tickets);
+int drawLotteryTree(const LotteryTree* lottery, long ticket);
+void destroyLotteryTree(LotteryTree* lottery);
+
+// Function declarations for IPC instance handling
+void setIpcId(const char* name, int id);
+int getIpcId(const char* name);
+int readInstanceId(const char* path, const char* name);
+void dieWithParent(int signum, pid_t parent);
+int startIpcReaper(int queue_id);
+
+// Function declarations for event tracing
+int openTrace(const char* path, int algorithm, int quantum, bool resume);
+void recordEvent(int time, int type, int process_id, int value);
+void flushTrace();
+void closeTrace();
+
+// Function declarations for latency histograms
+long long monotonicNs();
+void recordLatency(LatencyHistogram* histogram, long long ns);
+long long latencyPercentile(const LatencyHistogram* histogram, double percentile);
+void printLatencyHeader(FILE* file);
+void printLatency(FILE* file, const char* name, const LatencyHistogram* histogram);
+
+// Function declarations for the timing wheel
+TimerWheel* createTimerWheel(int now);
+void initTimer(Timer* timer, int type, int data);
+void addTimer(TimerWheel* wheel, Timer* timer, int expires);
+void cancelTimer(TimerWheel* wheel, Timer* timer);
+int advanceTimerWheel(TimerWheel* wheel, int now, TimerCallback callback);
+void destroyTimerWheel(TimerWheel* wheel);
+
+// Function declarations for checkpoints (see checkpoint.c)
+int saveCheckpoint(const char* path, const Checkpoint* checkpoint);
+int loadCheckpoint(const char* path, Checkpoint* checkpoint);
+int readCheckpointHeader(const char* path, CheckpointHeader* header);
+void freeCheckpoint(Checkpoint* checkpoint);
+
+// Function declarations for trace replay through the core (see sim.c)
+int simulateTrace(const Process* jobs, int count, int algorithm, int quantum, SimResult* result);
+int simulateTraceParallel(const Process* jobs, int count, int algorithm, int quantum, int threads,
+                          SimResult* result);
+
+// Scheduling policies (see policy.c and policy_<name>.c)
+extern const SchedPolicy hpf_policy;
+extern const SchedPolicy srtn_policy;
+extern const SchedPolicy rr_policy;
+extern const SchedPolicy lottery_policy;
+extern const SchedPolicy stride_policy;
+extern const SchedPolicy psrtn_policy;
+extern const SchedPolicy fairhpf_policy;
+extern const SchedPolicy fairsrtn_policy;
+extern const SchedPolicy fairrr_policy;
+extern const SchedPolicy cp_policy;
+const SchedPolicy* findPolicy(int algorithm);
+
+// Function declarations for the scheduling core used by the scheduler binary
+// and the policy modules (see schedcore.c)
+void schedStartClock(SchedCore*, int);
+int schedAdmit(SchedCore*, Process, bool);
+void schedEnqueue(SchedCore*, int);
+void schedSchedule(SchedCore*);
+void schedCompleteBurst(SchedCore*, int);
+int joinGroup(SchedCore*, const char*, int);
+void schedRebuildDependencies(SchedCore*);
+int currentWaitingTime(const SchedCore*, const Process*);
+int currentRemainingTime(const SchedCore*, const Process*);
+int currentEstimate(const SchedCore*, const Process*);
+long deviceBusyTime(const SchedCore*);
+int readyQueueSize(SchedCore*);
+void reportShares(SchedCore*, FILE*);
+void reportQuantum(SchedCore*, FILE*);
+void reportPrediction(SchedCore*, FILE*, double);
+void reportGroups(SchedCore*, FILE*);
+void reportDependencies(SchedCore*, FILE*);
+
 // Function declarations for scheduler
 int initClockShm();
 int initMessageQueue();
+int setFlowWindow(int);
 void clearResources(int);
-void readProcessFile(const char*);
+void readProcessFile(const char*, int);
+int parseBursts(const char*, Process*);
+int parseGroup(const char*, Process*);
+int parseDeps(const char*, Process*);
+void computeCriticalPaths(int);
+int parseCommand(char*, char**);
+int collectCredits(bool);
+void sendJob(int);
+void sendBacklog();
 void initScheduler(int);
-void processArrival(Process);
+Process* runningProcess();
+void processArrival(Process, const char*);
+void admitProcess(Process, const char*);
 void processTermination(int);
-void updateWaitingTimes();
-void scheduleProcess();
-void runProcess(Process*);
-void stopProcess(Process*);
+void recordLateness(const Process*);
+void returnCredits(int);
+void handleCoreEvent(void*, int, int);
+void launchProcess(Process*);
 void logProcess(Process*, const char*);
+void logProcessesInState(const char*, int);
 void logSystemState();
+void displayRunningProcess();
 void generatePerformanceMetrics();
+int initStatsShm();
+int attachStatsShm();
+void publishStats();
+int writeCheckpointImage();
+void takeCheckpoint();
+void fireTimer(Timer*);
+void restoreCheckpoint(const char*);
+void signalProcess(Process*, int);
+void execRealJob(const char*);
+void checkRealJobExit();
+void reportRealJobs();
+void reportArrivalFlow();
 
 // Global variables
 extern int msgq_id;
@@ -0,0 +1,98 @@
+#include "headers.h"
+#include <sys/prctl.h>
+#include <fcntl.h>
+#include <errno.h>
+
+// Each simulation instance owns private IPC objects created by process_generator.
+// Their identifiers travel to clk, scheduler and process through the environment,
+// so any number of instances can share a host without colliding on keys.
+
+// Function to export an IPC identifier to child processes
+void setIpcId(const char* name, int id) {
+    char value[16];
+    sprintf(value, "%d", id);
+    setenv(name, value, 1);
+}
+
+// Function to read an IPC identifier handed down by process_generator
+int getIpcId(const char* name) {
+    const char* value = getenv(name);
+    if (value == NULL) {
+        printf("Error: %s is not set (start the simulation with process_generator)\n", name);
+        exit(1);
+    }
+    return atoi(value);
+}
+
+// Function to look up an identifier in the instance file written by process_generator
+int readInstanceId(const char* path, const char* name) {
+    FILE* file = fopen(path, "r");
+    if (!file) return -1;
+
+    char line[128];
+    int id = -1;
+    size_t length = strlen(name);
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, name, length) == 0 && line[length] == '=') {
+            id = atoi(line + length + 1);
+            break;
+        }
+    }
+
+    fclose(file);
+    return id;
+}
+
+// Function to make the calling (freshly forked) process receive signum when its
+// parent exits, so nothing outlives a crashed instance
+void dieWithParent(int signum, pid_t parent) {
+    prctl(PR_SET_PDEATHSIG, signum);
+
+    // The parent may have exited before prctl() took effect
+    if (getppid() != parent) {
+        raise(signum);
+    }
+}
+
+// Function to start a helper that removes the message queue once the calling
+// process exits, even if it is killed with SIGKILL. The helper waits for EOF on
+// a pipe whose write end only the caller holds.
+int startIpcReaper(int queue_id) {
+    int fds[2];
+    if (pipe(fds) == -1) {
+        perror("Error creating reaper pipe");
+        return -1;
+    }
+
+    // Children exec'd later must not keep the write end open
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+    int pid = fork();
+    if (pid == -1) {
+        perror("Error starting IPC reaper");
+        return -1;
+    }
+
+    if (pid == 0) {
+        close(fds[1]);
+
+        // A distinct name keeps killall/pkill of the owner from hitting the reaper too
+        prctl(PR_SET_NAME, "ipc_reaper");
+
+        // Ctrl-C reaches the whole foreground group; the reaper must outlive the owner
+        signal(SIGINT, SIG_IGN);
+        signal(SIGTERM, SIG_IGN);
+
+        char byte;
+        ssize_t n;
+        do {
+            n = read(fds[0], &byte, 1);
+        } while (n > 0 || (n == -1 && errno == EINTR));
+
+        msgctl(queue_id, IPC_RMID, NULL);
+        _exit(0);
+    }
+
+    close(fds[0]);
+    return pid;
+}
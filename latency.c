@@ -0,0 +1,58 @@
+#include "headers.h"
+#include <time.h>
+
+// Low-overhead latency histograms: recording a sample is a clock read, a
+// leading-zero count and an increment, so it can sit on every hot path.
+
+// Function to read the monotonic clock in nanoseconds (comparable across processes)
+long long monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Function to add one sample to a histogram
+void recordLatency(LatencyHistogram* histogram, long long ns) {
+    if (ns < 0) ns = 0;
+
+    // Bucket i holds samples in [2^(i-1), 2^i)
+    int bucket = ns == 0 ? 0 : 64 - __builtin_clzll((unsigned long long)ns);
+    if (bucket >= LATENCY_BUCKETS) bucket = LATENCY_BUCKETS - 1;
+
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->total_ns += ns;
+    if (ns > histogram->max_ns) histogram->max_ns = ns;
+}
+
+// Function to estimate a percentile as the upper bound of the bucket that holds it
+long long latencyPercentile(const LatencyHistogram* histogram, double percentile) {
+    if (histogram->count == 0) return 0;
+
+    long rank = (long)ceil(histogram->count * percentile / 100.0);
+    if (rank < 1) rank = 1;
+
+    long seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            long long upper = i == 0 ? 0 : (1LL << i) - 1;
+            return upper < histogram->max_ns ? upper : histogram->max_ns;
+        }
+    }
+    return histogram->max_ns;
+}
+
+// Function to print the column header for printLatency()
+void printLatencyHeader(FILE* file) {
+    fprintf(file, "%-14s %10s %12s %12s %12s %12s\n",
+            "phase", "count", "mean_ns", "p50_ns", "p99_ns", "max_ns");
+}
+
+// Function to print one histogram as a summary row
+void printLatency(FILE* file, const char* name, const LatencyHistogram* histogram) {
+    double mean = histogram->count > 0 ? (double)histogram->total_ns / histogram->count : 0;
+    fprintf(file, "%-14s %10ld %12.0f %12lld %12lld %12lld\n", name, histogram->count, mean,
+            latencyPercentile(histogram, 50), latencyPercentile(histogram, 99),
+            histogram->max_ns);
+}
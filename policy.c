@@ -0,0 +1,27 @@
+#include "headers.h"
+
+// Registry of the scheduling policies the scheduler can be started with. A new
+// policy is a policy_<name>.c module exporting its SchedPolicy, listed here
+// and in the Makefile; the scheduler core needs no changes.
+static const SchedPolicy* policies[] = {
+    &hpf_policy,
+    &srtn_policy,
+    &rr_policy,
+    &lottery_policy,
+    &stride_policy,
+    &psrtn_policy,
+    &fairhpf_policy,
+    &fairsrtn_policy,
+    &fairrr_policy,
+    &cp_policy,
+};
+
+// Function to look up the policy behind an algorithm number, NULL if unknown
+const SchedPolicy* findPolicy(int algorithm) {
+    for (int i = 0; i < (int)(sizeof(policies) / sizeof(policies[0])); i++) {
+        if (policies[i]->algorithm == algorithm) {
+            return policies[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,49 @@
+#include "headers.h"
+
+// Critical path: non-preemptive, the ready process with the longest path to
+// the end of its DAG runs first, so the chain that bounds the pipeline's
+// latency is never kept waiting behind work with slack. Jobs without
+// dependencies count their own length, which makes this longest job first.
+
+static void cpInit(SchedCore* core) {
+    core->policy_state = createPriorityQueue(100);
+}
+
+static void cpEnqueue(SchedCore* core, Process* process) {
+    insertPriorityQueue(core->policy_state, -(long)process->critical_path, process);
+}
+
+static int cpPickNext(SchedCore* core) {
+    PriorityQueue* queue = core->policy_state;
+    if (queue->size == 0) return -1;
+    return removePriorityQueue(queue).table_index;
+}
+
+static int cpSize(SchedCore* core) {
+    return ((PriorityQueue*)core->policy_state)->size;
+}
+
+static int cpReadyOrder(SchedCore* core, int* order) {
+    return collectPriorityQueue(core->policy_state, order);
+}
+
+static void cpLogQueue(SchedCore* core, FILE* file) {
+    fprintf(file, "  Critical-path Queue size: %d\n", cpSize(core));
+}
+
+static void cpDestroy(SchedCore* core) {
+    destroyPriorityQueue(core->policy_state);
+}
+
+const SchedPolicy cp_policy = {
+    .algorithm = CRITICAL_PATH,
+    .name = "CP",
+    .time_sliced = false,
+    .init = cpInit,
+    .enqueue = cpEnqueue,
+    .pickNext = cpPickNext,
+    .size = cpSize,
+    .readyOrder = cpReadyOrder,
+    .logQueue = cpLogQueue,
+    .destroy = cpDestroy,
+};
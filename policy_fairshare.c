@@ -0,0 +1,254 @@
+#include "headers.h"
+
+// Hierarchical fair share: the CPU is split between groups by weight with
+// stride scheduling, and inside the group chosen the ready processes are
+// ordered by HPF, SRTN or RR. Groups with ready processes sit in a heap keyed
+// by their pass, each with a ready queue of its own, so both levels of a
+// decision are O(log n). The quantum is the slice a group gets before the
+// groups are compared again.
+//
+// The core charges a group for the CPU time its processes use (see
+// chargeGroup in schedcore.c). Only the group dispatched last can have been
+// charged since the heap was last touched, so it is moved down before the
+// heap is used; passes only grow. The group passes and core->group_pass, the
+// pass of the group dispatched last, live in the core so they are kept in
+// checkpoints.
+
+typedef struct {
+    int inner;             // HPF, SRTN or RR inside each group
+    void** queues;         // Ready queue of each group
+    int* heap;             // Groups with ready processes, smallest pass first
+    int* heap_pos;         // Place of each group in heap, -1 if absent
+    int heap_size;
+    int capacity;          // Groups the arrays have room for
+    int ready;             // Ready processes over all groups
+    int last_group;        // Group dispatched last, -1 before the first dispatch
+} FairShare;
+
+static void fairInit(SchedCore* core, int inner) {
+    FairShare* fair = (FairShare*)calloc(1, sizeof(FairShare));
+    fair->inner = inner;
+    fair->last_group = -1;
+    core->policy_state = fair;
+}
+
+static void fairHpfInit(SchedCore* core) {
+    fairInit(core, HPF);
+}
+
+static void fairSrtnInit(SchedCore* core) {
+    fairInit(core, SRTN);
+}
+
+static void fairRrInit(SchedCore* core) {
+    fairInit(core, RR);
+}
+
+// Function to tell whether group a comes before group b; ties go to the
+// group seen first so runs are repeatable
+static bool groupBefore(SchedCore* core, int a, int b) {
+    long pass_a = core->groups[a].pass;
+    long pass_b = core->groups[b].pass;
+    return pass_a < pass_b || (pass_a == pass_b && a < b);
+}
+
+static void swapGroups(FairShare* fair, int i, int j) {
+    int group = fair->heap[i];
+    fair->heap[i] = fair->heap[j];
+    fair->heap[j] = group;
+    fair->heap_pos[fair->heap[i]] = i;
+    fair->heap_pos[fair->heap[j]] = j;
+}
+
+static void heapifyUpGroup(SchedCore* core, FairShare* fair, int index) {
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!groupBefore(core, fair->heap[index], fair->heap[parent])) break;
+        swapGroups(fair, index, parent);
+        index = parent;
+    }
+}
+
+static void heapifyDownGroup(SchedCore* core, FairShare* fair, int index) {
+    while (1) {
+        int smallest = index;
+        int left = 2 * index + 1;
+        int right = 2 * index + 2;
+        if (left < fair->heap_size && groupBefore(core, fair->heap[left], fair->heap[smallest])) smallest = left;
+        if (right < fair->heap_size && groupBefore(core, fair->heap[right], fair->heap[smallest])) smallest = right;
+        if (smallest == index) break;
+        swapGroups(fair, index, smallest);
+        index = smallest;
+    }
+}
+
+// Function to make room for groups the core added since the last call
+static void growGroups(SchedCore* core, FairShare* fair) {
+    if (core->group_count <= fair->capacity) return;
+
+    int capacity = core->group_capacity;
+    fair->queues = realloc(fair->queues, capacity * sizeof(void*));
+    fair->heap = realloc(fair->heap, capacity * sizeof(int));
+    fair->heap_pos = realloc(fair->heap_pos, capacity * sizeof(int));
+    for (int g = fair->capacity; g < capacity; g++) {
+        fair->queues[g] = fair->inner == RR ? (void*)createCircularQueue(16) : (void*)createPriorityQueue(16);
+        fair->heap_pos[g] = -1;
+    }
+    fair->capacity = capacity;
+}
+
+// Function to move the group dispatched last to its place for the CPU time
+// it was charged since
+static void settleLastGroup(SchedCore* core, FairShare* fair) {
+    if (fair->last_group != -1 && fair->heap_pos[fair->last_group] != -1) {
+        heapifyDownGroup(core, fair, fair->heap_pos[fair->last_group]);
+    }
+}
+
+static int groupQueueSize(FairShare* fair, int group) {
+    if (fair->inner == RR) return ((CircularQueue*)fair->queues[group])->size;
+    return ((PriorityQueue*)fair->queues[group])->size;
+}
+
+// Function to queue a ready process in its group. A group that had nothing
+// ready joins at the current pass, so it cannot bank the time it was idle.
+static void fairEnqueue(SchedCore* core, Process* process) {
+    FairShare* fair = core->policy_state;
+    growGroups(core, fair);
+    settleLastGroup(core, fair);
+
+    int group = process->group;
+    if (fair->inner == HPF) {
+        insertPriorityQueue(fair->queues[group], process->priority, process);
+    } else if (fair->inner == SRTN) {
+        insertPriorityQueue(fair->queues[group], process->remaining_time, process);
+    } else {
+        enqueueCircularQueue(fair->queues[group], process->table_index);
+    }
+    fair->ready++;
+
+    if (fair->heap_pos[group] == -1) {
+        if (core->groups[group].pass < core->group_pass) core->groups[group].pass = core->group_pass;
+        fair->heap[fair->heap_size] = group;
+        fair->heap_pos[group] = fair->heap_size++;
+        heapifyUpGroup(core, fair, fair->heap_pos[group]);
+    }
+}
+
+// Function to take the next process from the group with the smallest pass
+static int fairPickNext(SchedCore* core) {
+    FairShare* fair = core->policy_state;
+    settleLastGroup(core, fair);
+    if (fair->heap_size == 0) return -1;
+
+    int group = fair->heap[0];
+    core->group_pass = core->groups[group].pass;
+    fair->last_group = group;
+
+    int next;
+    if (fair->inner == RR) {
+        next = dequeueCircularQueue(fair->queues[group]);
+    } else {
+        next = removePriorityQueue(fair->queues[group]).table_index;
+    }
+    fair->ready--;
+
+    // A group with nothing left leaves the heap until a process of it is ready again
+    if (groupQueueSize(fair, group) == 0) {
+        fair->heap_pos[group] = -1;
+        fair->heap_size--;
+        if (fair->heap_size > 0) {
+            fair->heap[0] = fair->heap[fair->heap_size];
+            fair->heap_pos[fair->heap[0]] = 0;
+            heapifyDownGroup(core, fair, 0);
+        }
+    }
+    return next;
+}
+
+// Function to tell whether a process of the running one's group has strictly
+// less left; other groups wait for the end of the quantum
+static bool fairSrtnPreempts(SchedCore* core, Process* running) {
+    FairShare* fair = core->policy_state;
+    if (running->group >= fair->capacity) return false;
+    PriorityQueue* queue = fair->queues[running->group];
+    return queue->size > 0 && currentRemainingTime(core, running) > queue->array[0].key;
+}
+
+static int fairSize(SchedCore* core) {
+    return ((FairShare*)core->policy_state)->ready;
+}
+
+static int fairReadyOrder(SchedCore* core, int* order) {
+    FairShare* fair = core->policy_state;
+    int count = 0;
+    for (int i = 0; i < fair->heap_size; i++) {
+        int group = fair->heap[i];
+        if (fair->inner == RR) {
+            count += collectCircularQueue(fair->queues[group], order + count);
+        } else {
+            count += collectPriorityQueue(fair->queues[group], order + count);
+        }
+    }
+    return count;
+}
+
+static void fairLogQueue(SchedCore* core, FILE* file) {
+    FairShare* fair = core->policy_state;
+    fprintf(file, "  Fair-share Queue size: %d in %d groups\n", fair->ready, fair->heap_size);
+}
+
+static void fairDestroy(SchedCore* core) {
+    FairShare* fair = core->policy_state;
+    for (int g = 0; g < fair->capacity; g++) {
+        if (fair->inner == RR) {
+            destroyCircularQueue(fair->queues[g]);
+        } else {
+            destroyPriorityQueue(fair->queues[g]);
+        }
+    }
+    free(fair->queues);
+    free(fair->heap);
+    free(fair->heap_pos);
+    free(fair);
+}
+
+const SchedPolicy fairhpf_policy = {
+    .algorithm = FAIR_HPF,
+    .name = "FAIR_HPF",
+    .time_sliced = true,
+    .init = fairHpfInit,
+    .enqueue = fairEnqueue,
+    .pickNext = fairPickNext,
+    .size = fairSize,
+    .readyOrder = fairReadyOrder,
+    .logQueue = fairLogQueue,
+    .destroy = fairDestroy,
+};
+
+const SchedPolicy fairsrtn_policy = {
+    .algorithm = FAIR_SRTN,
+    .name = "FAIR_SRTN",
+    .time_sliced = true,
+    .init = fairSrtnInit,
+    .enqueue = fairEnqueue,
+    .pickNext = fairPickNext,
+    .preempts = fairSrtnPreempts,
+    .size = fairSize,
+    .readyOrder = fairReadyOrder,
+    .logQueue = fairLogQueue,
+    .destroy = fairDestroy,
+};
+
+const SchedPolicy fairrr_policy = {
+    .algorithm = FAIR_RR,
+    .name = "FAIR_RR",
+    .time_sliced = true,
+    .init = fairRrInit,
+    .enqueue = fairEnqueue,
+    .pickNext = fairPickNext,
+    .size = fairSize,
+    .readyOrder = fairReadyOrder,
+    .logQueue = fairLogQueue,
+    .destroy = fairDestroy,
+};
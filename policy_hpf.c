@@ -0,0 +1,47 @@
+#include "headers.h"
+
+// Highest Priority First: non-preemptive, the ready process with the highest
+// priority (smallest number) runs to the end of its burst
+
+static void hpfInit(SchedCore* core) {
+    core->policy_state = createPriorityQueue(100);
+}
+
+static void hpfEnqueue(SchedCore* core, Process* process) {
+    insertPriorityQueue(core->policy_state, process->priority, process);
+}
+
+static int hpfPickNext(SchedCore* core) {
+    PriorityQueue* queue = core->policy_state;
+    if (queue->size == 0) return -1;
+    return removePriorityQueue(queue).table_index;
+}
+
+static int hpfSize(SchedCore* core) {
+    return ((PriorityQueue*)core->policy_state)->size;
+}
+
+static int hpfReadyOrder(SchedCore* core, int* order) {
+    return collectPriorityQueue(core->policy_state, order);
+}
+
+static void hpfLogQueue(SchedCore* core, FILE* file) {
+    fprintf(file, "  HPF Queue size: %d\n", hpfSize(core));
+}
+
+static void hpfDestroy(SchedCore* core) {
+    destroyPriorityQueue(core->policy_state);
+}
+
+const SchedPolicy hpf_policy = {
+    .algorithm = HPF,
+    .name = "HPF",
+    .time_sliced = false,
+    .init = hpfInit,
+    .enqueue = hpfEnqueue,
+    .pickNext = hpfPickNext,
+    .size = hpfSize,
+    .readyOrder = hpfReadyOrder,
+    .logQueue = hpfLogQueue,
+    .destroy = hpfDestroy,
+};
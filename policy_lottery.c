@@ -0,0 +1,65 @@
+#include "headers.h"
+
+// Lottery: each quantum goes to the holder of a ticket drawn at random from
+// the tickets of all ready processes, which are indexed by table slot. The
+// draws come from core->lottery_seed, which snapshots keep, so a resumed run
+// draws the same.
+
+static void lotteryInit(SchedCore* core) {
+    core->policy_state = createLotteryTree(128);
+}
+
+static void lotteryEnqueue(SchedCore* core, Process* process) {
+    setLotteryTickets(core->policy_state, process->table_index, process->tickets);
+}
+
+static int lotteryPickNext(SchedCore* core) {
+    LotteryTree* lottery = core->policy_state;
+    if (lottery->total == 0) return -1;
+    core->lottery_seed = core->lottery_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    long ticket = (long)((core->lottery_seed >> 33) % lottery->total);
+    int slot = drawLotteryTree(lottery, ticket);
+    setLotteryTickets(lottery, slot, 0);
+    return slot;
+}
+
+static int lotterySize(SchedCore* core) {
+    return ((LotteryTree*)core->policy_state)->size;
+}
+
+// Function to list the slots in the draw; the draw has no order, so slot order it is
+static int lotteryReadyOrder(SchedCore* core, int* order) {
+    LotteryTree* lottery = core->policy_state;
+    int count = 0;
+    for (int slot = 0; slot < lottery->capacity; slot++) {
+        if (lottery->tickets[slot] > 0) order[count++] = slot;
+    }
+    return count;
+}
+
+static void lotteryLogQueue(SchedCore* core, FILE* file) {
+    LotteryTree* lottery = core->policy_state;
+    fprintf(file, "  Lottery size: %d (%ld tickets)\n", lottery->size, lottery->total);
+}
+
+static void lotteryReport(SchedCore* core, FILE* file, double avg_wta) {
+    reportShares(core, file);
+}
+
+static void lotteryDestroy(SchedCore* core) {
+    destroyLotteryTree(core->policy_state);
+}
+
+const SchedPolicy lottery_policy = {
+    .algorithm = LOTTERY,
+    .name = "LOTTERY",
+    .time_sliced = true,
+    .init = lotteryInit,
+    .enqueue = lotteryEnqueue,
+    .pickNext = lotteryPickNext,
+    .size = lotterySize,
+    .readyOrder = lotteryReadyOrder,
+    .logQueue = lotteryLogQueue,
+    .report = lotteryReport,
+    .destroy = lotteryDestroy,
+};
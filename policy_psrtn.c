@@ -0,0 +1,64 @@
+#include "headers.h"
+
+// Predictive SRTN: SRTN ordered by the predicted CPU time left in the current
+// burst (see currentEstimate) instead of the runtime from the trace
+
+static void psrtnInit(SchedCore* core) {
+    core->policy_state = createPriorityQueue(100);
+}
+
+static void psrtnEnqueue(SchedCore* core, Process* process) {
+    insertPriorityQueue(core->policy_state, process->estimate, process);
+}
+
+static int psrtnPickNext(SchedCore* core) {
+    PriorityQueue* queue = core->policy_state;
+    if (queue->size == 0) return -1;
+    return removePriorityQueue(queue).table_index;
+}
+
+static bool psrtnPreempts(SchedCore* core, Process* running) {
+    PriorityQueue* queue = core->policy_state;
+    return queue->size > 0 && currentEstimate(core, running) > queue->array[0].key;
+}
+
+// Function to freeze the estimate of a process leaving the CPU, while its
+// running time can still be read
+static void psrtnOnPreempt(SchedCore* core, Process* process, int ran) {
+    process->estimate = currentEstimate(core, process);
+}
+
+static int psrtnSize(SchedCore* core) {
+    return ((PriorityQueue*)core->policy_state)->size;
+}
+
+static int psrtnReadyOrder(SchedCore* core, int* order) {
+    return collectPriorityQueue(core->policy_state, order);
+}
+
+static void psrtnLogQueue(SchedCore* core, FILE* file) {
+    fprintf(file, "  PSRTN Queue size: %d\n", psrtnSize(core));
+}
+
+static void psrtnDestroy(SchedCore* core) {
+    destroyPriorityQueue(core->policy_state);
+}
+
+// A running burst that outlives its prediction has its estimate corrected
+// upwards as it runs, so the check on arrival is repeated every tick
+const SchedPolicy psrtn_policy = {
+    .algorithm = PSRTN,
+    .name = "PSRTN",
+    .time_sliced = false,
+    .init = psrtnInit,
+    .enqueue = psrtnEnqueue,
+    .pickNext = psrtnPickNext,
+    .preempts = psrtnPreempts,
+    .onTick = psrtnPreempts,
+    .onPreempt = psrtnOnPreempt,
+    .size = psrtnSize,
+    .readyOrder = psrtnReadyOrder,
+    .logQueue = psrtnLogQueue,
+    .report = reportPrediction,
+    .destroy = psrtnDestroy,
+};
@@ -0,0 +1,47 @@
+#include "headers.h"
+
+// Round Robin: ready processes take turns in arrival order, each for one time
+// quantum
+
+static void rrInit(SchedCore* core) {
+    core->policy_state = createCircularQueue(100);
+}
+
+static void rrEnqueue(SchedCore* core, Process* process) {
+    enqueueCircularQueue(core->policy_state, process->table_index);
+}
+
+static int rrPickNext(SchedCore* core) {
+    CircularQueue* queue = core->policy_state;
+    if (isCircularQueueEmpty(queue)) return -1;
+    return dequeueCircularQueue(queue);
+}
+
+static int rrSize(SchedCore* core) {
+    return ((CircularQueue*)core->policy_state)->size;
+}
+
+static int rrReadyOrder(SchedCore* core, int* order) {
+    return collectCircularQueue(core->policy_state, order);
+}
+
+static void rrLogQueue(SchedCore* core, FILE* file) {
+    fprintf(file, "  RR Queue size: %d\n", rrSize(core));
+}
+
+static void rrDestroy(SchedCore* core) {
+    destroyCircularQueue(core->policy_state);
+}
+
+const SchedPolicy rr_policy = {
+    .algorithm = RR,
+    .name = "RR",
+    .time_sliced = true,
+    .init = rrInit,
+    .enqueue = rrEnqueue,
+    .pickNext = rrPickNext,
+    .size = rrSize,
+    .readyOrder = rrReadyOrder,
+    .logQueue = rrLogQueue,
+    .destroy = rrDestroy,
+};
@@ -0,0 +1,56 @@
+#include "headers.h"
+
+// Shortest Remaining Time Next: the ready process with the least runtime left
+// runs, and a process made ready with less left than the running one
+// preempts it
+
+static void srtnInit(SchedCore* core) {
+    core->policy_state = createPriorityQueue(100);
+}
+
+static void srtnEnqueue(SchedCore* core, Process* process) {
+    insertPriorityQueue(core->policy_state, process->remaining_time, process);
+}
+
+static int srtnPickNext(SchedCore* core) {
+    PriorityQueue* queue = core->policy_state;
+    if (queue->size == 0) return -1;
+    return removePriorityQueue(queue).table_index;
+}
+
+// Function to tell whether the shortest ready process has strictly less left
+// than the running one; a tie keeps the running process
+static bool srtnPreempts(SchedCore* core, Process* running) {
+    PriorityQueue* queue = core->policy_state;
+    return queue->size > 0 && currentRemainingTime(core, running) > queue->array[0].key;
+}
+
+static int srtnSize(SchedCore* core) {
+    return ((PriorityQueue*)core->policy_state)->size;
+}
+
+static int srtnReadyOrder(SchedCore* core, int* order) {
+    return collectPriorityQueue(core->policy_state, order);
+}
+
+static void srtnLogQueue(SchedCore* core, FILE* file) {
+    fprintf(file, "  SRTN Queue size: %d\n", srtnSize(core));
+}
+
+static void srtnDestroy(SchedCore* core) {
+    destroyPriorityQueue(core->policy_state);
+}
+
+const SchedPolicy srtn_policy = {
+    .algorithm = SRTN,
+    .name = "SRTN",
+    .time_sliced = false,
+    .init = srtnInit,
+    .enqueue = srtnEnqueue,
+    .pickNext = srtnPickNext,
+    .preempts = srtnPreempts,
+    .size = srtnSize,
+    .readyOrder = srtnReadyOrder,
+    .logQueue = srtnLogQueue,
+    .destroy = srtnDestroy,
+};
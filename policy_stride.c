@@ -0,0 +1,66 @@
+#include "headers.h"
+
+// Stride: each quantum goes to the ready process with the smallest pass, and
+// a process's pass advances by STRIDE_ONE / tickets per tick it runs.
+// core->stride_pass is the pass of the last process dispatched.
+
+static void strideInit(SchedCore* core) {
+    core->policy_state = createPriorityQueue(100);
+}
+
+// Function to queue a ready process. One that just arrived or comes back from
+// I/O starts at the current pass, so it cannot bank the passes it missed.
+static void strideEnqueue(SchedCore* core, Process* process) {
+    if (process->pass < core->stride_pass) process->pass = core->stride_pass;
+    insertPriorityQueue(core->policy_state, process->pass, process);
+}
+
+static int stridePickNext(SchedCore* core) {
+    PriorityQueue* queue = core->policy_state;
+    if (queue->size == 0) return -1;
+    QueueEntry next = removePriorityQueue(queue);
+    core->stride_pass = next.key;
+    return next.table_index;
+}
+
+// Function to advance the pass of a process by the CPU time it used
+static void strideOnPreempt(SchedCore* core, Process* process, int ran) {
+    if (ran > 0) {
+        process->pass += (STRIDE_ONE / process->tickets) * ran;
+    }
+}
+
+static int strideSize(SchedCore* core) {
+    return ((PriorityQueue*)core->policy_state)->size;
+}
+
+static int strideReadyOrder(SchedCore* core, int* order) {
+    return collectPriorityQueue(core->policy_state, order);
+}
+
+static void strideLogQueue(SchedCore* core, FILE* file) {
+    fprintf(file, "  Stride Queue size: %d\n", strideSize(core));
+}
+
+static void strideReport(SchedCore* core, FILE* file, double avg_wta) {
+    reportShares(core, file);
+}
+
+static void strideDestroy(SchedCore* core) {
+    destroyPriorityQueue(core->policy_state);
+}
+
+const SchedPolicy stride_policy = {
+    .algorithm = STRIDE,
+    .name = "STRIDE",
+    .time_sliced = true,
+    .init = strideInit,
+    .enqueue = strideEnqueue,
+    .pickNext = stridePickNext,
+    .onPreempt = strideOnPreempt,
+    .size = strideSize,
+    .readyOrder = strideReadyOrder,
+    .logQueue = strideLogQueue,
+    .report = strideReport,
+    .destroy = strideDestroy,
+};
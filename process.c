@@ -14,12 +14,10 @@ int main(int argc, char *argv[]) {
     int remaining_time = atoi(argv[1]);
     
     // Attach to shared memory and message queue
-    key_t key_shm = ftok("keyfile", 'C');
-    shm_id = shmget(key_shm, sizeof(SharedClock), 0666);
+    shm_id = getIpcId(ENV_CLOCK_SHM);
     shm_clock = (SharedClock *)shmat(shm_id, NULL, 0);
     
-    key_t key_msg = ftok("keyfile", 'M');
-    msgq_id = msgget(key_msg, 0666);
+    msgq_id = getIpcId(ENV_MSGQ);
     
     // Get process ID
     int pid = getpid();
@@ -34,8 +32,9 @@ int main(int argc, char *argv[]) {
     Message msg;
     msg.mtype = PROCESS_TERMINATION;
     msg.process.id = pid;
+    msg.sent_ns = monotonicNs();
     
-    if (msgsnd(msgq_id, &msg, sizeof(msg.process), !IPC_NOWAIT) == -1) {
+    if (msgsnd(msgq_id, &msg, MESSAGE_SIZE, !IPC_NOWAIT) == -1) {
         perror("Error sending termination message");
         exit(1);
     }
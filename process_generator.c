@@ -3,20 +3,360 @@
 int msgq_id;
 int shm_id;
 SharedClock *shm_clock;
+int stats_shm_id;
+SchedStats *stats_page;
 int scheduler_pid;
 int clk_pid;
+int exit_status = 0; // Non-zero once the scheduler failed
 
-// Function to read process data from input file
-void readProcessFile(const char* filename) {
+// Jobs read from the input file, each released by its own arrival timer
+Process* arrivals = NULL;
+char** arrival_commands = NULL; // Command line of each real job, NULL for simulated ones
+Timer* arrival_timers = NULL;
+
+// Flow control towards the scheduler
+FlowCounters flow = { 0, OVERFLOW_BLOCK, 0, 0, 0, 0, 0 };
+int in_flight = 0;           // Arrival messages the scheduler has not consumed yet
+int* backlog = NULL;         // Jobs held back while the window is full (OVERFLOW_COALESCE)
+int backlog_head = 0;
+int backlog_count = 0;
+
+// Function to fill in the burst profile of a process from the optional
+// "bursts=cpu,io,cpu,..." field of its line. Without the field the job is a
+// single CPU burst. Returns -1 if the field is malformed.
+int parseBursts(const char* line, Process* process) {
+    process->burst_count = 1;
+    process->bursts[0] = process->runtime;
+    
+    const char* field = strstr(line, "bursts=");
+    if (field == NULL) return 0;
+    
+    int count = 0;
+    int cpu_total = 0;
+    const char* cursor = field + strlen("bursts=");
+    while (count < MAX_BURSTS) {
+        char* end;
+        long value = strtol(cursor, &end, 10);
+        if (end == cursor || value <= 0) return -1;
+        
+        process->bursts[count] = (int)value;
+        if (count % 2 == 0) cpu_total += (int)value;
+        count++;
+        
+        if (*end != ',') break;
+        cursor = end + 1;
+    }
+    
+    // The job has to end with a CPU burst
+    if (count % 2 == 0) return -1;
+    
+    process->burst_count = count;
+    if (cpu_total != process->runtime) {
+        printf("Warning: process %d runtime %d does not match its CPU bursts, using %d\n",
+               process->id, process->runtime, cpu_total);
+        process->runtime = cpu_total;
+    }
+    return 0;
+}
+
+// Function to take back the credits the scheduler returned, waiting for at
+// least one if wait is set. Returns the number of credits collected.
+int collectCredits(bool wait) {
+    AckMessage ack;
+    int collected = 0;
+    while (msgrcv(msgq_id, &ack, ACK_SIZE, ARRIVAL_ACK, wait && collected == 0 ? 0 : IPC_NOWAIT) != -1) {
+        collected += ack.credits;
+    }
+    in_flight -= collected;
+    return collected;
+}
+
+// Function to read the owner of a process from the optional
+// "group=name[:weight]" field of its line. Without the field the job belongs
+// to DEFAULT_GROUP with weight 1. Returns -1 if the field is malformed.
+int parseGroup(const char* line, Process* process) {
+    snprintf(process->group_name, sizeof(process->group_name), "%s", DEFAULT_GROUP);
+    process->group_weight = 1;
+    process->group = -1;
+    
+    const char* field = strstr(line, "group=");
+    if (field == NULL) return 0;
+    
+    const char* name = field + strlen("group=");
+    int length = strcspn(name, ": \t\r\n");
+    if (length == 0 || length >= MAX_GROUP_NAME) return -1;
+    memcpy(process->group_name, name, length);
+    process->group_name[length] = '\0';
+    
+    if (name[length] == ':') {
+        char* end;
+        long weight = strtol(name + length + 1, &end, 10);
+        if (end == name + length + 1 || weight <= 0) return -1;
+        process->group_weight = (int)weight;
+    }
+    return 0;
+}
+
+// Function to send one job to the scheduler in a message of its own
+void sendJob(int index) {
+    Message msg;
+    msg.mtype = PROCESS_ARRIVAL;
+    msg.process = arrivals[index];
+    msg.sent_ns = monotonicNs();
+    msg.position = index;
+    msg.command[0] = '\0';
+    if (arrival_commands[index] != NULL) {
+        strcpy(msg.command, arrival_commands[index]);
+    }
+    if (msgsnd(msgq_id, &msg, MESSAGE_SIZE, !IPC_NOWAIT) == -1) {
+        perror("Error sending message");
+        exit(1);
+    }
+    in_flight++;
+    flow.sent++;
+    
+    printf("Process %d sent to scheduler at time %d\n", 
+           msg.process.id, shm_clock->current_time);
+}
+
+// Function to send the jobs held back while the window was full, coalescing
+// consecutive simulated jobs so each message uses a single credit
+void sendBacklog() {
+    while (backlog_count > 0 && in_flight < flow.window) {
+        int index = backlog[backlog_head];
+        if (arrival_commands[index] != NULL || backlog_count == 1) {
+            sendJob(index);
+            backlog_head++;
+            backlog_count--;
+            continue;
+        }
+        
+        BatchMessage batch;
+        batch.mtype = PROCESS_BATCH;
+        batch.count = 0;
+        while (backlog_count > 0 && batch.count < ARRIVAL_BATCH &&
+               arrival_commands[backlog[backlog_head]] == NULL) {
+            batch.processes[batch.count++] = arrivals[backlog[backlog_head]];
+            backlog_head++;
+            backlog_count--;
+        }
+        batch.sent_ns = monotonicNs();
+        batch.position = backlog[backlog_head - 1];
+        if (msgsnd(msgq_id, &batch, BATCH_SIZE, !IPC_NOWAIT) == -1) {
+            perror("Error sending message");
+            exit(1);
+        }
+        in_flight++;
+        flow.sent++;
+        flow.coalesced += batch.count;
+        
+        printf("Processes %d-%d sent to scheduler together at time %d\n",
+               batch.processes[0].id, batch.processes[batch.count - 1].id, shm_clock->current_time);
+    }
+}
+
+// Function to send the job of an expired arrival timer to the scheduler,
+// applying the overflow policy when the window is full
+void sendArrival(Timer* timer) {
+    collectCredits(false);
+    
+    if (flow.overflow == OVERFLOW_COALESCE) {
+        // Jobs already held back go first, so arrival order is kept
+        backlog[backlog_head + backlog_count++] = timer->data;
+        sendBacklog();
+        return;
+    }
+    
+    if (in_flight >= flow.window) {
+        if (flow.overflow == OVERFLOW_DROP) {
+            flow.dropped++;
+            printf("Process %d dropped at time %d: %d messages in flight\n",
+                   arrivals[timer->data].id, shm_clock->current_time, in_flight);
+            return;
+        }
+        
+        long long stall_start = monotonicNs();
+        flow.stalls++;
+        while (in_flight >= flow.window) {
+            collectCredits(true);
+        }
+        flow.stall_ns += monotonicNs() - stall_start;
+    }
+    
+    sendJob(timer->data);
+}
+
+// Function to take the optional trailing "cmd=<command line>" field off a line.
+// The command runs to the end of the line, so it is cut off before the other
+// fields are parsed. Sets *command to a copy of it, or NULL for a simulated job,
+// and returns -1 if the field is empty or too long.
+int parseCommand(char* line, char** command) {
+    *command = NULL;
+    char* field = strstr(line, "cmd=");
+    if (field == NULL) return 0;
+    
+    char* text = field + strlen("cmd=");
+    text[strcspn(text, "\r\n")] = '\0';
+    *field = '\0';
+    if (text[0] == '\0' || strlen(text) >= MAX_COMMAND) return -1;
+    
+    *command = strdup(text);
+    return 0;
+}
+
+// Function to read the parents of a process from the optional "deps=id,id,..."
+// field of its line. Returns -1 if the field is malformed.
+int parseDeps(const char* line, Process* process) {
+    process->dep_count = 0;
+    process->critical_path = 0;
+    
+    const char* field = strstr(line, "deps=");
+    if (field == NULL) return 0;
+    
+    const char* cursor = field + strlen("deps=");
+    while (1) {
+        char* end;
+        long id = strtol(cursor, &end, 10);
+        if (end == cursor || id < 0 || id > INT_MAX || id == process->id || process->dep_count == MAX_DEPS) return -1;
+        
+        process->deps[process->dep_count++] = (int)id;
+        if (*end != ',') break;
+        cursor = end + 1;
+    }
+    return 0;
+}
+
+// Function to compare two jobs by id, then by place in the file
+int compareIds(const void* a, const void* b) {
+    const int* x = a;
+    const int* y = b;
+    if (arrivals[*x].id != arrivals[*y].id) {
+        return arrivals[*x].id < arrivals[*y].id ? -1 : 1;
+    }
+    return *x - *y;
+}
+
+// Function to find the last job with an id listed before place position,
+// searching the jobs sorted by compareIds. Returns its place, or -1.
+int findListed(const int* by_id, int count, int id, int position) {
+    int low = 0;
+    int high = count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        int other = by_id[mid];
+        if (arrivals[other].id < id || (arrivals[other].id == id && other < position)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low > 0 && arrivals[by_id[low - 1]].id == id) return by_id[low - 1];
+    return -1;
+}
+
+// Function to give every job the length of the longest path from it to the
+// end of its DAG (its bottom level), counting CPU and I/O bursts. Parents
+// must be listed before their children, which also rules out cycles, so one
+// pass from the last job back settles every path. Without dependencies the
+// paths are left for the scheduler, which takes a job's own length.
+void computeCriticalPaths(int count) {
+    bool has_deps = false;
+    for (int i = 0; i < count && !has_deps; i++) {
+        has_deps = arrivals[i].dep_count > 0;
+    }
+    if (!has_deps) return;
+
+    // Parents are found by id in the jobs sorted by id, so ids may be sparse
+    int* by_id = malloc(count * sizeof(int));
+    int* length = malloc(count * sizeof(int));
+    if (!by_id || !length) {
+        perror("Error allocating critical paths");
+        exit(1);
+    }
+    for (int i = 0; i < count; i++) by_id[i] = i;
+    qsort(by_id, count, sizeof(int), compareIds);
+    
+    for (int i = 0; i < count; i++) {
+        for (int d = 0; d < arrivals[i].dep_count; d++) {
+            int parent = arrivals[i].deps[d];
+            if (findListed(by_id, count, parent, i) == -1) {
+                printf("Error: process %d depends on %d, which is not listed before it\n",
+                       arrivals[i].id, parent);
+                exit(1);
+            }
+        }
+        
+        arrivals[i].critical_path = 0;
+        for (int b = 0; b < arrivals[i].burst_count; b++) {
+            arrivals[i].critical_path += arrivals[i].bursts[b];
+        }
+    }
+    
+    // A job's path is final once every child, all listed after it, is done
+    for (int i = 0; i < count; i++) length[i] = arrivals[i].critical_path;
+    for (int i = count - 1; i >= 0; i--) {
+        for (int d = 0; d < arrivals[i].dep_count; d++) {
+            int position = findListed(by_id, count, arrivals[i].deps[d], i);
+            Process* parent = &arrivals[position];
+            int path = length[position] + arrivals[i].critical_path;
+            if (path > parent->critical_path) parent->critical_path = path;
+        }
+    }
+    
+    free(length);
+    free(by_id);
+}
+
+// Function to compare two jobs by arrival time, then by place in the file
+int compareArrivals(const void* a, const void* b) {
+    const int* x = a;
+    const int* y = b;
+    if (arrivals[*x].arrival_time != arrivals[*y].arrival_time) {
+        return arrivals[*x].arrival_time - arrivals[*y].arrival_time;
+    }
+    return *x - *y;
+}
+
+// Function to order the jobs by arrival time, keeping file order on the same
+// tick, so a job's index is its place in the order they are sent
+void sortArrivals(int count) {
+    int* order = malloc((count > 0 ? count : 1) * sizeof(int));
+    Process* sorted = malloc((count > 0 ? count : 1) * sizeof(Process));
+    char** sorted_commands = malloc((count > 0 ? count : 1) * sizeof(char*));
+    if (!order || !sorted || !sorted_commands) {
+        perror("Error allocating arrivals");
+        exit(1);
+    }
+    for (int i = 0; i < count; i++) order[i] = i;
+    qsort(order, count, sizeof(int), compareArrivals);
+    for (int i = 0; i < count; i++) {
+        sorted[i] = arrivals[order[i]];
+        sorted_commands[i] = arrival_commands[order[i]];
+    }
+    free(arrivals);
+    free(arrival_commands);
+    arrivals = sorted;
+    arrival_commands = sorted_commands;
+    free(order);
+}
+
+// Function to read process data from input file and release every job to the
+// scheduler at its arrival time, skipping the first skip jobs in arrival order.
+// A resumed run skips the jobs the scheduler had seen sent or dropped before
+// its checkpoint; only jobs dropped after the last one it received go out again.
+void readProcessFile(const char* filename, int skip) {
     FILE *file = fopen(filename, "r");
     if (!file) {
         perror("Error opening process file");
         exit(1);
     }
 
-    char line[100];
+    char line[MAX_COMMAND + 256];
+    char* command;
     Process process;
     Message msg;
+    int count = 0;
+    int capacity = 0;
 
     // Skip comment lines
     while (fgets(line, sizeof(line), file)) {
@@ -26,6 +366,34 @@ void readProcessFile(const char* filename) {
         if (sscanf(line, "%d\t%d\t%d\t%d", &process.id, &process.arrival_time, 
                    &process.runtime, &process.priority) == 4) {
             
+            
+            if (process.id < 0) {
+                printf("Error: process %d has a negative id\n", process.id);
+                exit(1);
+            }
+            if (parseCommand(line, &command) == -1) {
+                printf("Error: bad cmd field for process %d\n", process.id);
+                exit(1);
+            }
+            if (parseBursts(line, &process) == -1) {
+                printf("Error: bad bursts field for process %d\n", process.id);
+                exit(1);
+            }
+            if (parseGroup(line, &process) == -1) {
+                printf("Error: bad group field for process %d\n", process.id);
+                exit(1);
+            }
+            if (parseDeps(line, &process) == -1) {
+                printf("Error: bad deps field for process %d\n", process.id);
+                exit(1);
+            }
+            
+            // A real job does its own I/O
+            if (command != NULL && process.burst_count > 1) {
+                printf("Error: process %d has both a cmd and a bursts field\n", process.id);
+                exit(1);
+            }
+            
             // Initialize Process fields
             process.remaining_time = process.runtime;
             process.waiting_time = 0;
@@ -33,34 +401,73 @@ void readProcessFile(const char* filename) {
             process.start_time = -1;
             process.finish_time = -1;
             process.last_run_time = -1;
+            process.ready_since = -1;
+            process.pid = 0;
+            process.table_index = -1;
+            process.burst_index = 0;
+            process.burst_remaining = process.bursts[0];
             process.prempted = false;
             process.memsize = 0; // Not used in this implementation
             
-            // Wait until the process arrival time
-            while (shm_clock->current_time < process.arrival_time) {
-                usleep(100000); // Sleep for 100ms
-            }
-            
-            // Send process to scheduler
-            msg.mtype = PROCESS_ARRIVAL;
-            msg.process = process;
-            if (msgsnd(msgq_id, &msg, sizeof(msg.process), !IPC_NOWAIT) == -1) {
-                perror("Error sending message");
-                exit(1);
+            if (count == capacity) {
+                capacity = capacity > 0 ? capacity * 2 : 64;
+                arrivals = realloc(arrivals, capacity * sizeof(Process));
+                arrival_commands = realloc(arrival_commands, capacity * sizeof(char*));
             }
-            
-            printf("Process %d sent to scheduler at time %d\n", 
-                   process.id, shm_clock->current_time);
+            arrival_commands[count] = command;
+            arrivals[count++] = process;
         }
     }
     
     fclose(file);
+    
+    // Paths need every job, including those delivered before a checkpoint
+    computeCriticalPaths(count);
+    sortArrivals(count);
+    
+    // One timer per job; jobs arriving on the same tick are sent in file order.
+    // The timers live in an array that no longer grows, so the wheel may link them.
+    TimerWheel* wheel = createTimerWheel(shm_clock->current_time);
+    arrival_timers = malloc((count > 0 ? count : 1) * sizeof(Timer));
+    backlog = malloc((count > 0 ? count : 1) * sizeof(int));
+    for (int i = skip; i < count; i++) {
+        initTimer(&arrival_timers[i], TIMER_ARRIVAL, i);
+        addTimer(wheel, &arrival_timers[i], arrivals[i].arrival_time);
+    }
+    
+    // Wait for the clock and send each job once its arrival time is reached;
+    // jobs held back go out as credits come back
+    while (1) {
+        collectCredits(false);
+        sendBacklog();
+        advanceTimerWheel(wheel, shm_clock->current_time, sendArrival);
+        if (wheel->pending == 0 && backlog_count == 0) break;
+        usleep(100000); // Sleep for 100ms
+    }
+    
+    destroyTimerWheel(wheel);
+    free(backlog);
+    for (int i = 0; i < count; i++) {
+        free(arrival_commands[i]);
+    }
+    free(arrival_commands);
+    free(arrival_timers);
+    free(arrivals);
+    
+    // Tell the scheduler that no more processes will arrive, and how the
+    // arrivals were delivered
+    msg.mtype = GENERATOR_DONE;
+    msg.sent_ns = monotonicNs();
+    msg.flow = flow;
+    if (msgsnd(msgq_id, &msg, MESSAGE_SIZE, !IPC_NOWAIT) == -1) {
+        perror("Error sending message");
+        exit(1);
+    }
 }
 
 // Function to initialize shared memory for clock
 int initClockShm() {
-    key_t key = ftok("keyfile", 'C');
-    shm_id = shmget(key, sizeof(SharedClock), IPC_CREAT | 0666);
+    shm_id = shmget(IPC_PRIVATE, sizeof(SharedClock), IPC_CREAT | 0600);
     if (shm_id == -1) {
         perror("Error creating shared memory");
         exit(1);
@@ -72,22 +479,87 @@ int initClockShm() {
         exit(1);
     }
     
+    // The segment is freed once the last process of this instance detaches,
+    // even if nobody gets to run clearResources()
+    shmctl(shm_id, IPC_RMID, NULL);
+    setIpcId(ENV_CLOCK_SHM, shm_id);
+    
     return shm_id;
 }
 
+// Function to initialize the read-only statistics page the scheduler publishes to
+int initStatsShm() {
+    stats_shm_id = shmget(IPC_PRIVATE, sizeof(SchedStats), IPC_CREAT | 0644);
+    if (stats_shm_id == -1) {
+        perror("Error creating statistics page");
+        exit(1);
+    }
+    
+    stats_page = (SchedStats *)shmat(stats_shm_id, NULL, 0);
+    if ((void *)stats_page == (void *)-1) {
+        perror("Error attaching statistics page");
+        exit(1);
+    }
+    
+    memset(stats_page, 0, sizeof(SchedStats));
+    shmctl(stats_shm_id, IPC_RMID, NULL);
+    setIpcId(ENV_STATS_SHM, stats_shm_id);
+    
+    return stats_shm_id;
+}
+
 // Function to initialize message queue
 int initMessageQueue() {
-    key_t key = ftok("keyfile", 'M');
-    msgq_id = msgget(key, IPC_CREAT | 0666);
+    msgq_id = msgget(IPC_PRIVATE, IPC_CREAT | 0600);
     if (msgq_id == -1) {
         perror("Error creating message queue");
         exit(1);
     }
     
+    // Message queues are not reference counted, so a helper removes it if we crash
+    startIpcReaper(msgq_id);
+    setIpcId(ENV_MSGQ, msgq_id);
+    
     return msgq_id;
 }
 
-// Function to clean up resources
+// Function to size the window of arrival messages. The queue holds
+// msg_qbytes bytes, and arrivals may use half of it, leaving the rest for
+// termination reports and credits. A larger request is clamped to that.
+int setFlowWindow(int requested) {
+    struct msqid_ds info;
+    if (msgctl(msgq_id, IPC_STAT, &info) == -1) {
+        perror("Error reading message queue limits");
+        exit(1);
+    }
+    
+    size_t largest = sizeof(Message) > sizeof(BatchMessage) ? sizeof(Message) : sizeof(BatchMessage);
+    int limit = (int)(info.msg_qbytes / largest / 2);
+    if (limit < 1) limit = 1;
+    
+    if (requested > limit) {
+        printf("Warning: window of %d messages does not fit the queue, using %d\n", requested, limit);
+    }
+    flow.window = requested > 0 && requested < limit ? requested : limit;
+    return flow.window;
+}
+
+// Function to record the identifiers of this instance for observers like schedstat
+void writeInstanceFile() {
+    FILE *file = fopen(INSTANCE_FILE, "w");
+    if (!file) {
+        perror("Error writing instance file");
+        return;
+    }
+    
+    fprintf(file, "%s=%d\n", ENV_CLOCK_SHM, shm_id);
+    fprintf(file, "%s=%d\n", ENV_MSGQ, msgq_id);
+    fprintf(file, "%s=%d\n", ENV_STATS_SHM, stats_shm_id);
+    fclose(file);
+}
+
+// Function to clean up resources. The exit status tells a run that completed
+// from one that was interrupted (128 + signal) or whose scheduler failed.
 void clearResources(int signum) {
     // Kill child processes
     if (scheduler_pid > 0) kill(scheduler_pid, SIGKILL);
@@ -96,62 +568,163 @@ void clearResources(int signum) {
     // Remove IPC resources
     msgctl(msgq_id, IPC_RMID, NULL);
     shmdt(shm_clock);
-    shmctl(shm_id, IPC_RMID, NULL);
+    shmdt(stats_page);
+    unlink(INSTANCE_FILE);
     
     printf("Resources cleared\n");
-    exit(0);
+    exit(signum > 0 ? 128 + signum : exit_status);
 }
 
 int main(int argc, char *argv[]) {
+    // Scheduling options may be given on the command line for non-interactive runs
+    int algorithm = 0;
+    int quantum = -1;
+    int percentile = 0;
+    const char* process_file = "processes.txt";
+    const char* restore_path = NULL;
+    int checkpoint_every = 0;
+    int real_cpu = -1;
+    int window = 0;
+    
+    int opt;
+    while ((opt = getopt(argc, argv, "a:q:f:c:r:p:P:w:o:")) != -1) {
+        if (opt == 'a') {
+            algorithm = atoi(optarg);
+        } else if (opt == 'q') {
+            quantum = atoi(optarg);
+        } else if (opt == 'f') {
+            process_file = optarg;
+        } else if (opt == 'c') {
+            checkpoint_every = atoi(optarg);
+        } else if (opt == 'r') {
+            restore_path = optarg;
+        } else if (opt == 'p') {
+            real_cpu = atoi(optarg);
+        } else if (opt == 'P') {
+            percentile = atoi(optarg);
+        } else if (opt == 'w') {
+            window = atoi(optarg);
+        } else if (opt == 'o' && strcmp(optarg, "block") == 0) {
+            flow.overflow = OVERFLOW_BLOCK;
+        } else if (opt == 'o' && strcmp(optarg, "drop") == 0) {
+            flow.overflow = OVERFLOW_DROP;
+        } else if (opt == 'o' && strcmp(optarg, "coalesce") == 0) {
+            flow.overflow = OVERFLOW_COALESCE;
+        } else {
+            printf("Usage: %s [-a algorithm] [-q quantum, 0 for adaptive] [-P quantum_percentile] "
+                   "[-f process_file] [-c checkpoint_ticks] [-r checkpoint] [-p real_job_cpu] "
+                   "[-w window] [-o block|drop|coalesce]\n",
+                   argv[0]);
+            exit(1);
+        }
+    }
+    
+    // A resumed run takes its clock and position in the process file from the
+    // snapshot, and its algorithm and quantum unless they were given; the
+    // scheduler refuses a snapshot taken with others
+    CheckpointHeader snapshot;
+    int start_time = 0;
+    int skip = 0;
+    if (restore_path != NULL) {
+        if (readCheckpointHeader(restore_path, &snapshot) == -1) exit(1);
+        if (algorithm == 0) algorithm = snapshot.algorithm;
+        if (quantum < 0) quantum = snapshot.quantum;
+        start_time = snapshot.time;
+        skip = snapshot.trace_position;
+        setenv(ENV_RESTORE, restore_path, 1);
+    }
+    if (checkpoint_every > 0) {
+        setIpcId(ENV_CHECKPOINT_EVERY, checkpoint_every);
+    }
+    if (real_cpu >= 0) {
+        setIpcId(ENV_REAL_CPU, real_cpu);
+    }
+    if (percentile > 0) {
+        setIpcId(ENV_QUANTUM_PERCENTILE, percentile);
+    }
+    
     // Set up signal handler for cleanup
     signal(SIGINT, clearResources);
+    signal(SIGTERM, clearResources);
+    signal(SIGHUP, clearResources);
     
-    // Initialize IPC
+    // Initialize IPC private to this instance
     initClockShm();
+    initStatsShm();
     initMessageQueue();
+    setFlowWindow(window);
+    writeInstanceFile();
+    shm_clock->current_time = start_time;
     
     // Create clock process
+    int generator_pid = getpid();
     clk_pid = fork();
     if (clk_pid == 0) {
-        execl("./clk", "clk", NULL);
+        dieWithParent(SIGKILL, generator_pid);
+        
+        char start_str[12];
+        sprintf(start_str, "%d", start_time);
+        execl("./clk", "clk", start_str, NULL);
         perror("Error executing clock");
         exit(1);
     }
     
-    // Get scheduling algorithm from user
-    int algorithm;
-    int quantum = 0;
-    
-    printf("Choose scheduling algorithm:\n");
-    printf("1. Non-preemptive Highest Priority First (HPF)\n");
-    printf("2. Shortest Remaining Time Next (SRTN)\n");
-    printf("3. Round Robin (RR)\n");
-    printf("Enter your choice (1-3): ");
-    scanf("%d", &algorithm);
+    // Ask the user for anything not given on the command line
+    if (algorithm == 0) {
+        printf("Choose scheduling algorithm:\n");
+        printf("1. Non-preemptive Highest Priority First (HPF)\n");
+        printf("2. Shortest Remaining Time Next (SRTN)\n");
+        printf("3. Round Robin (RR)\n");
+        printf("4. Lottery (tickets from priority)\n");
+        printf("5. Stride (tickets from priority)\n");
+        printf("6. Predictive SRTN (runtimes unknown to the scheduler)\n");
+        printf("7. Fair share across groups, HPF inside each group\n");
+        printf("8. Fair share across groups, SRTN inside each group\n");
+        printf("9. Fair share across groups, RR inside each group\n");
+        printf("10. Critical path first (jobs with dependencies)\n");
+        printf("Enter your choice (1-10): ");
+        scanf("%d", &algorithm);
+    }
     
-    if (algorithm == RR) {
-        printf("Enter time quantum for RR: ");
+    if (USES_QUANTUM(algorithm) && quantum < 0) {
+        printf("Enter time quantum (%d for adaptive): ", ADAPTIVE_QUANTUM);
         scanf("%d", &quantum);
     }
     
     // Create scheduler process
     scheduler_pid = fork();
     if (scheduler_pid == 0) {
+        dieWithParent(SIGKILL, generator_pid);
+        
         char alg_str[10], quantum_str[10];
         sprintf(alg_str, "%d", algorithm);
         sprintf(quantum_str, "%d", quantum);
         
+        // Prefer the scheduler specialized for the algorithm, falling back to
+        // the generic one when it was not built
+        const char* engines[] = ENGINE_NAMES;
+        if (algorithm >= HPF && algorithm <= ALGORITHM_COUNT) {
+            char engine_path[64];
+            snprintf(engine_path, sizeof(engine_path), "./%s", engines[algorithm]);
+            execl(engine_path, engines[algorithm], alg_str, quantum_str, NULL);
+        }
+        
         execl("./scheduler", "scheduler", alg_str, quantum_str, NULL);
         perror("Error executing scheduler");
         exit(1);
     }
     
     // Read process file and send processes to scheduler
-    readProcessFile("processes.txt");
+    readProcessFile(process_file, skip);
     
     // Wait for scheduler to finish
     int status;
     waitpid(scheduler_pid, &status, 0);
+    scheduler_pid = 0;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        printf("Error: scheduler did not finish cleanly\n");
+        exit_status = 1;
+    }
     
     // Clean up resources
     clearResources(0);
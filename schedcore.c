@@ -0,0 +1,1161 @@
+#include "headers.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Scheduling core: the process table, the policy's ready queue, the I/O device
+// and all the accounting, driven by the time the caller passes in. The caller
+// learns about every state change through the event callback (see
+// schedcore.h); the scheduler binary uses it to fork, stop and resume the
+// real processes and to write its logs.
+//
+// Timers for the quantum, the running CPU burst and the I/O device live on a
+// timing wheel of the core's own, which schedAdvance() moves forward.
+
+// A core built with -DSCHED_POLICY=<name>_policy is specialized for one
+// policy: every hook is known at build time, so link-time optimization calls
+// (and mostly inlines) them directly instead of through the table.
+#ifdef SCHED_POLICY
+extern const SchedPolicy SCHED_POLICY;
+#endif
+
+static inline const SchedPolicy* policyOf(const SchedCore* core) {
+#ifdef SCHED_POLICY
+    return &SCHED_POLICY;
+#else
+    return core->policy;
+#endif
+}
+
+// Function to tell the caller about a state change
+static void notify(SchedCore* core, int type, int index) {
+    if (core->callback != NULL) {
+        core->callback(core->context, type, index);
+    }
+}
+
+// Function to create a core for an algorithm, or NULL if the algorithm is
+// unknown, not built into this core or missing its quantum
+SchedCore* schedCreate(int algorithm, int quantum) {
+    const SchedPolicy* policy = findPolicy(algorithm);
+#ifdef SCHED_POLICY
+    if (policy != &SCHED_POLICY) policy = NULL;
+#endif
+    if (policy == NULL || (policy->time_sliced && quantum < 0)) {
+        return NULL;
+    }
+
+    SchedCore* core = (SchedCore*)calloc(1, sizeof(SchedCore));
+    core->policy = policy;
+    core->algorithm = algorithm;
+    core->quantum = quantum;
+    core->running_index = -1;
+    core->io_index = -1;
+    core->lottery_seed = 12345;
+    core->adaptive_quantum = policy->time_sliced && quantum == ADAPTIVE_QUANTUM;
+    core->quantum_percentile = DEFAULT_QUANTUM_PERCENTILE;
+    core->slice_min = INT_MAX;
+    core->overall_estimate = 1;
+
+    // The table and every queue grow on demand
+    core->table = createProcessTable(100);
+    core->io_queue = createCircularQueue(100);
+    core->timers = createTimerWheel(0);
+    initTimer(&core->quantum_timer, TIMER_QUANTUM, -1);
+    initTimer(&core->burst_timer, TIMER_BURST, -1);
+    initTimer(&core->io_timer, TIMER_IO, -1);
+    policy->init(core);
+    return core;
+}
+
+// Function to set the callback told about every state change
+void schedSetCallback(SchedCore* core, SchedEventCallback callback, void* context) {
+    core->callback = callback;
+    core->context = context;
+}
+
+// Function to find the core a timer belongs to from the timer's place in it
+static SchedCore* coreOfTimer(Timer* timer) {
+    if (timer->type == TIMER_QUANTUM) {
+        return (SchedCore*)((char*)timer - offsetof(SchedCore, quantum_timer));
+    } else if (timer->type == TIMER_BURST) {
+        return (SchedCore*)((char*)timer - offsetof(SchedCore, burst_timer));
+    }
+    return (SchedCore*)((char*)timer - offsetof(SchedCore, io_timer));
+}
+
+// Function to account idle and total time since the last call. Waiting time is
+// settled lazily from ready_since, so this is O(1) regardless of queue length.
+static void updateWaitingTimes(SchedCore* core) {
+    int time_diff = core->now - core->last_clock;
+    if (time_diff <= 0) return;
+
+    // If no process is running, increment idle time
+    if (core->running_index == -1) {
+        core->idle_time += time_diff;
+    }
+
+    core->last_clock = core->now;
+    core->total_runtime += time_diff;
+}
+
+// Function to start the core's clock at a time other than 0 without counting
+// the time before it as idle
+void schedStartClock(SchedCore* core, int now) {
+    core->now = now;
+    core->last_clock = now;
+    core->share_last_time = now;
+    core->timers->now = now;
+}
+
+// Function to move the core's time to now without firing any timer, so work
+// done at now (an arrival, a process reporting its exit) comes first
+void schedSetTime(SchedCore* core, int now) {
+    if (now > core->now) {
+        core->now = now;
+    }
+    updateWaitingTimes(core);
+}
+
+// Function to advance the per-ticket clock to the current time
+static void advanceShareClock(SchedCore* core) {
+    if (core->active_tickets > 0 && core->now > core->share_last_time) {
+        core->share_clock += (double)(core->now - core->share_last_time) / core->active_tickets;
+    }
+    core->share_last_time = core->now;
+}
+
+// Function to add a process that became runnable to the ticket share
+static void joinShare(SchedCore* core, Process* process) {
+    advanceShareClock(core);
+    process->share_mark = core->share_clock;
+    core->active_tickets += process->tickets;
+}
+
+// Function to settle the entitlement of a process that stops being runnable
+static void leaveShare(SchedCore* core, Process* process) {
+    advanceShareClock(core);
+    process->entitled_time += process->tickets * (core->share_clock - process->share_mark);
+    core->active_tickets -= process->tickets;
+}
+
+// Function to find the group of a job by name, adding it with the given
+// weight the first time it is seen. Returns the group's slot.
+int joinGroup(SchedCore* core, const char* name, int weight) {
+    if (name[0] == '\0') name = DEFAULT_GROUP;
+    for (int i = 0; i < core->group_count; i++) {
+        if (strcmp(core->groups[i].name, name) == 0) return i;
+    }
+
+    if (core->group_count == core->group_capacity) {
+        core->group_capacity = core->group_capacity > 0 ? core->group_capacity * 2 : 8;
+        core->groups = realloc(core->groups, core->group_capacity * sizeof(SchedGroup));
+    }
+    SchedGroup* group = &core->groups[core->group_count];
+    snprintf(group->name, sizeof(group->name), "%s", name);
+    group->weight = weight > 0 ? weight : 1;
+    group->pass = 0;
+    return core->group_count++;
+}
+
+// Function to advance the pass of a group by the CPU time one of its
+// processes just used
+static void chargeGroup(SchedCore* core, Process* process, int ran) {
+    SchedGroup* group = &core->groups[process->group];
+    if (ran > 0) {
+        group->pass += (STRIDE_ONE / group->weight) * ran;
+    }
+}
+
+// Function to get the waiting time of a process including its current wait
+int currentWaitingTime(const SchedCore* core, const Process* process) {
+    if (process->ready_since == -1) {
+        return process->waiting_time;
+    }
+    return process->waiting_time + (core->now - process->ready_since);
+}
+
+// Function to get the remaining time of a process including the slice it is running now
+int currentRemainingTime(const SchedCore* core, const Process* process) {
+    if (process->state != RUNNING) {
+        return process->remaining_time;
+    }
+    return process->remaining_time - (core->now - process->last_run_time);
+}
+
+// Function to get the time the I/O device has been busy so far, leaving out
+// the part of the current burst that still lies in the future
+long deviceBusyTime(const SchedCore* core) {
+    long busy = core->io_busy_time;
+    if (core->io_index != -1 && core->io_done_time > core->now) {
+        busy -= core->io_done_time - core->now;
+    }
+    return busy;
+}
+
+// Function to predict the length of a CPU burst about to start for a process
+// of the given priority class
+static int predictBurst(const SchedCore* core, int priority) {
+    if (priority < 0) priority = 0;
+    if (priority > MAX_PRIORITY) priority = MAX_PRIORITY;
+    double estimate = core->class_seen[priority] ? core->class_estimate[priority] : core->overall_estimate;
+    int predicted = (int)lround(estimate);
+    return predicted > 0 ? predicted : 1;
+}
+
+// Function to score the prediction for a CPU burst that just completed and
+// fold its actual length into the averages of its class and of all classes
+static void observeBurst(SchedCore* core, Process* process) {
+    int priority = process->priority < 0 ? 0 : process->priority > MAX_PRIORITY ? MAX_PRIORITY : process->priority;
+    int actual = process->bursts[process->burst_index];
+    int error = process->predicted_burst - actual;
+
+    core->prediction_count[priority]++;
+    core->prediction_abs_error[priority] += abs(error);
+    core->prediction_bias += error;
+    core->prediction_rel_error += (double)abs(error) / actual;
+
+    core->class_estimate[priority] = core->class_seen[priority] ?
+        PREDICTION_ALPHA * actual + (1 - PREDICTION_ALPHA) * core->class_estimate[priority] : actual;
+    core->class_seen[priority] = true;
+    core->overall_estimate = core->overall_seen ?
+        PREDICTION_ALPHA * actual + (1 - PREDICTION_ALPHA) * core->overall_estimate : actual;
+    core->overall_seen = true;
+}
+
+// Function to get the predicted CPU time a process has left in its burst. Once
+// a burst outlives its prediction the estimate is corrected to the time the
+// burst has run so far: a job that ran long is expected to run as long again.
+int currentEstimate(const SchedCore* core, const Process* process) {
+    if (process->state != RUNNING) {
+        return process->estimate;
+    }
+    int ran = core->now - process->last_run_time;
+    if (process->estimate - ran > 0) {
+        return process->estimate - ran;
+    }
+    int used = process->bursts[process->burst_index] - process->burst_remaining + ran;
+    return used > 0 ? used : 1;
+}
+
+// Function to get the number of processes in the ready queue
+int readyQueueSize(SchedCore* core) {
+    return policyOf(core)->size(core);
+}
+
+// Function to remember the length of a CPU burst that just completed
+static void recordBurst(SchedCore* core, int length) {
+    if (!core->adaptive_quantum) return;
+    core->burst_window[core->burst_window_next] = length;
+    core->burst_window_next = (core->burst_window_next + 1) % QUANTUM_WINDOW;
+    if (core->burst_window_count < QUANTUM_WINDOW) core->burst_window_count++;
+}
+
+// Function to get the length of the time slice for a process being dispatched.
+// The adaptive quantum is a percentile (the median by default) of the CPU
+// bursts completed recently. A process whose burst fits in it runs the burst
+// to the end instead of being preempted just short of finishing; a longer one
+// shares the quantum with everything in the ready queue, so the jobs behind
+// it get the CPU again soon.
+static int sliceLength(SchedCore* core, Process* process) {
+    if (!core->adaptive_quantum) return core->quantum;
+
+    int sorted[QUANTUM_WINDOW];
+    for (int i = 0; i < core->burst_window_count; i++) {
+        int value = core->burst_window[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+
+    int rank = (core->quantum_percentile * core->burst_window_count + 99) / 100;
+    if (rank < 1) rank = 1;
+    int adaptive = core->burst_window_count > 0 ? sorted[rank - 1] : 1;
+
+    int ready = readyQueueSize(core);
+    int slice = process->burst_remaining;
+    if (slice > adaptive || slice < 1) {
+        slice = adaptive / (ready + 1);
+        if (slice < 1) slice = 1;
+    }
+
+    core->slice_total += slice;
+    core->slice_count++;
+    if (slice < core->slice_min) core->slice_min = slice;
+    if (slice > core->slice_max) core->slice_max = slice;
+
+    if (adaptive != core->current_quantum) {
+        if (core->quantum_sample_count == core->quantum_sample_capacity) {
+            core->quantum_sample_capacity = core->quantum_sample_capacity > 0 ? core->quantum_sample_capacity * 2 : 64;
+            core->quantum_samples = realloc(core->quantum_samples,
+                                            core->quantum_sample_capacity * sizeof(QuantumSample));
+        }
+        QuantumSample* sample = &core->quantum_samples[core->quantum_sample_count++];
+        sample->time = core->now;
+        sample->quantum = adaptive;
+        sample->ready = ready;
+        core->current_quantum = adaptive;
+    }
+    return slice;
+}
+
+// Function to hand a process that became ready to the policy's ready queue
+void schedEnqueue(SchedCore* core, int index) {
+    long long queue_start = monotonicNs();
+    policyOf(core)->enqueue(core, &core->table->records[index]);
+    recordLatency(&core->queue_latency, monotonicNs() - queue_start);
+}
+
+// Function to find the slot of a job id in the dependency hash: the one
+// holding it, or the empty one it would take. The hash is at most half full,
+// so a probe ends soon.
+static size_t dependencySlot(const SchedCore* core, int id) {
+    size_t mask = core->dep_capacity - 1;
+    size_t slot = ((size_t)id * 2654435761u) & mask;
+    while (core->dep_nodes[slot].id != -1 && core->dep_nodes[slot].id != id) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// Function to get the dependency node of a job id, or NULL if it has none
+static DependencyNode* findDependencyNode(const SchedCore* core, int id) {
+    if (core->dep_capacity == 0) return NULL;
+    DependencyNode* node = &core->dep_nodes[dependencySlot(core, id)];
+    return node->id == id ? node : NULL;
+}
+
+// Function to double the slots of the dependency hash, moving every node
+static void growDependencyNodes(SchedCore* core) {
+    size_t capacity = core->dep_capacity > 0 ? core->dep_capacity * 2 : 64;
+    if (capacity < core->dep_capacity || capacity > SIZE_MAX / sizeof(DependencyNode)) {
+        printf("Error: too many dependency nodes\n");
+        exit(1);
+    }
+
+    DependencyNode* old_nodes = core->dep_nodes;
+    size_t old_capacity = core->dep_capacity;
+    core->dep_nodes = malloc(capacity * sizeof(DependencyNode));
+    if (!core->dep_nodes) {
+        perror("Error allocating dependency nodes");
+        exit(1);
+    }
+    core->dep_capacity = capacity;
+    for (size_t i = 0; i < capacity; i++) core->dep_nodes[i].id = -1;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_nodes[i].id != -1) core->dep_nodes[dependencySlot(core, old_nodes[i].id)] = old_nodes[i];
+    }
+    free(old_nodes);
+}
+
+// Function to get the dependency node of a job id, adding it if it has none.
+// Adding a node may move the others, so earlier pointers are not kept.
+static DependencyNode* dependencyNode(SchedCore* core, int id) {
+    DependencyNode* node = findDependencyNode(core, id);
+    if (node != NULL) return node;
+
+    if (core->dep_count >= core->dep_capacity / 2) growDependencyNodes(core);
+    node = &core->dep_nodes[dependencySlot(core, id)];
+    node->id = id;
+    node->index = -1;
+    node->finished = false;
+    node->children = NULL;
+    node->child_count = 0;
+    node->child_capacity = 0;
+    core->dep_count++;
+    return node;
+}
+
+// Function to start tracking dependencies when the first job with parents
+// shows up, giving a node to every job admitted so far; a trace without
+// dependencies never builds the hash
+static void trackDependencies(SchedCore* core) {
+    core->has_deps = true;
+    for (int i = 0; i < core->table->count; i++) {
+        Process* process = &core->table->records[i];
+        DependencyNode* node = dependencyNode(core, process->id);
+        node->index = i;
+        node->finished = process->state == FINISHED;
+    }
+}
+
+// Function to record that a pending job waits for the job of a node
+static void addChild(DependencyNode* node, int index) {
+    if (node->child_count == node->child_capacity) {
+        node->child_capacity = node->child_capacity > 0 ? node->child_capacity * 2 : 4;
+        node->children = realloc(node->children, node->child_capacity * sizeof(int));
+    }
+    node->children[node->child_count++] = index;
+}
+
+// Function to get the time a job takes on its own, I/O included
+static int pathLength(const Process* process) {
+    int length = 0;
+    for (int i = 0; i < process->burst_count; i++) {
+        length += process->bursts[i];
+    }
+    return length;
+}
+
+// Function to mark the job of a node finished and move every child whose
+// last parent it was from the pending set to the ready queue. Each edge is
+// visited once, so a release costs O(1) per edge.
+static void releaseChildren(SchedCore* core, DependencyNode* node) {
+    node->finished = true;
+    int* children = node->children;
+    int child_count = node->child_count;
+    node->children = NULL;
+    node->child_count = 0;
+    node->child_capacity = 0;
+
+    for (int i = 0; i < child_count; i++) {
+        int index = children[i];
+        Process* child = &core->table->records[index];
+        if (--child->indegree > 0) continue;
+
+        setProcessState(core->table, index, READY);
+        child->ready_since = core->now;
+        joinShare(core, child);
+        notify(core, EVENT_RELEASE, index);
+        schedEnqueue(core, index);
+    }
+    free(children);
+}
+
+// Function to add an arrived process to the table and its ready queue without
+// scheduling, returning its table index. An open-ended process is one whose
+// bursts end when the caller says so even if the trace runtime has not run out.
+int schedAdmit(SchedCore* core, Process process, bool open_ended) {
+    // Account for elapsed time before the ready set changes
+    updateWaitingTimes(core);
+
+    // The process has been waiting since its arrival, even if it was handed
+    // over late
+    process.state = READY;
+    process.pid = 0; // Not forked yet
+    process.open_ended = open_ended;
+    process.ready_since = process.arrival_time;
+    process.tickets = (MAX_PRIORITY + 1 - process.priority) * TICKETS_PER_LEVEL;
+    if (process.tickets <= 0) process.tickets = 1;
+    process.pass = 0;
+    process.entitled_time = 0;
+    process.predicted_burst = predictBurst(core, process.priority);
+    process.estimate = process.predicted_burst;
+    process.group = joinGroup(core, process.group_name, process.group_weight);
+    snprintf(process.group_name, sizeof(process.group_name), "%s", core->groups[process.group].name);
+    process.group_weight = core->groups[process.group].weight;
+    if (process.critical_path <= 0) process.critical_path = pathLength(&process);
+
+    // A job with parents still to finish waits in the pending set; its wait
+    // for the CPU starts when it is released
+    process.indegree = 0;
+    if (process.dep_count > 0 && !core->has_deps) trackDependencies(core);
+    for (int i = 0; i < process.dep_count; i++) {
+        if (!dependencyNode(core, process.deps[i])->finished) process.indegree++;
+    }
+    if (process.indegree > 0) {
+        process.state = PENDING;
+        process.ready_since = -1;
+    }
+
+    // Add process to process table; the queued copy carries its table index
+    int index = addProcessToTable(core->table, process);
+    if (core->has_deps) dependencyNode(core, process.id)->index = index;
+    for (int i = 0; i < process.dep_count; i++) {
+        DependencyNode* parent = dependencyNode(core, process.deps[i]);
+        if (!parent->finished) addChild(parent, index);
+    }
+
+    // Allocate memory for statistics arrays
+    core->turnaround_times = realloc(core->turnaround_times, core->table->count * sizeof(double));
+    core->weighted_turnaround_times = realloc(core->weighted_turnaround_times,
+                                              core->table->count * sizeof(double));
+
+    notify(core, EVENT_ARRIVAL, index);
+    if (process.indegree == 0) {
+        joinShare(core, &core->table->records[index]);
+        schedEnqueue(core, index);
+    }
+    return index;
+}
+
+// Function to submit a job arriving now and schedule at once, returning its
+// slot or -1 if its id is negative or it does not describe a valid burst
+// profile
+int schedSubmit(SchedCore* core, const SchedJob* job) {
+    Process process;
+    memset(&process, 0, sizeof(process));
+    process.id = job->id;
+    process.priority = job->priority;
+    process.arrival_time = core->now;
+    process.start_time = -1;
+    process.finish_time = -1;
+    process.last_run_time = -1;
+
+    if (job->burst_count > 0) {
+        if (job->burst_count > MAX_BURSTS || job->burst_count % 2 == 0) return -1;
+        process.burst_count = job->burst_count;
+        for (int i = 0; i < job->burst_count; i++) {
+            if (job->bursts[i] <= 0) return -1;
+            process.bursts[i] = job->bursts[i];
+            if (i % 2 == 0) process.runtime += job->bursts[i];
+        }
+    } else {
+        if (job->runtime <= 0) return -1;
+        process.runtime = job->runtime;
+        process.burst_count = 1;
+        process.bursts[0] = job->runtime;
+    }
+    process.remaining_time = process.runtime;
+    process.burst_remaining = process.bursts[0];
+    snprintf(process.group_name, sizeof(process.group_name), "%s", job->group);
+    process.group_weight = job->group_weight;
+    if (job->id < 0) return -1;
+    if (job->dep_count < 0 || job->dep_count > MAX_DEPS) return -1;
+    for (int i = 0; i < job->dep_count; i++) {
+        if (job->deps[i] < 0 || job->deps[i] == job->id) return -1;
+        process.deps[i] = job->deps[i];
+    }
+    process.dep_count = job->dep_count;
+    process.critical_path = job->critical_path;
+
+    int index = schedAdmit(core, process, false);
+    schedSchedule(core);
+    return index;
+}
+
+// Function to hand the I/O device to the next blocked process at time start
+static void startNextIo(SchedCore* core, int start) {
+    if (core->io_queue->size == 0) {
+        core->io_index = -1;
+        cancelTimer(core->timers, &core->io_timer);
+        return;
+    }
+
+    core->io_index = dequeueCircularQueue(core->io_queue);
+    const Process* next = &core->table->records[core->io_index];
+    int burst = next->bursts[next->burst_index];
+    core->io_done_time = start + burst;
+    core->io_busy_time += burst;
+    addTimer(core->timers, &core->io_timer, core->io_done_time);
+}
+
+// Function to return processes whose I/O burst has completed to the ready queue,
+// returning how many did. Completions are stamped with the time the device
+// finished, even when the core is told the time later.
+static int checkIoCompletions(SchedCore* core) {
+    int completed = 0;
+    while (core->io_index != -1 && core->now >= core->io_done_time) {
+        int index = core->io_index;
+        Process* process = &core->table->records[index];
+        int done_time = core->io_done_time;
+
+        process->burst_index++;
+        process->burst_remaining = process->bursts[process->burst_index];
+        process->predicted_burst = predictBurst(core, process->priority);
+        process->estimate = process->predicted_burst;
+        setProcessState(core->table, index, READY);
+        process->ready_since = done_time;
+        joinShare(core, process);
+
+        notify(core, EVENT_IO_DONE, index);
+        schedEnqueue(core, index);
+        completed++;
+
+        startNextIo(core, done_time);
+    }
+
+    return completed;
+}
+
+// Function to move a process that completed a CPU burst to the I/O device
+static void blockProcess(SchedCore* core, int index) {
+    updateWaitingTimes(core);
+
+    Process* process = &core->table->records[index];
+    const SchedPolicy* policy = policyOf(core);
+    chargeGroup(core, process, core->now - process->last_run_time);
+    if (policy->onPreempt != NULL) {
+        policy->onPreempt(core, process, core->now - process->last_run_time);
+    }
+    leaveShare(core, process);
+    recordBurst(core, process->bursts[process->burst_index]);
+    observeBurst(core, process);
+    process->remaining_time -= process->burst_remaining;
+    process->burst_remaining = 0;
+    process->burst_index++;
+    setProcessState(core->table, index, BLOCKED);
+
+    if (core->running_index == index) {
+        core->running_index = -1;
+        cancelTimer(core->timers, &core->quantum_timer);
+        cancelTimer(core->timers, &core->burst_timer);
+    }
+
+    notify(core, EVENT_BLOCK, index);
+
+    enqueueCircularQueue(core->io_queue, index);
+    if (core->io_index == -1) {
+        startNextIo(core, core->now);
+    }
+
+    schedSchedule(core);
+}
+
+// Function to end the CPU burst a process is in: it moves on to the I/O device
+// if it has more bursts and finishes otherwise. The core calls this itself
+// when a burst runs out, unless external_bursts leaves it to the caller.
+void schedCompleteBurst(SchedCore* core, int index) {
+    Process* process = &core->table->records[index];
+
+    // More bursts mean the process goes to the I/O device instead of finishing
+    if (process->burst_index + 1 < process->burst_count) {
+        blockProcess(core, index);
+        return;
+    }
+
+    updateWaitingTimes(core);
+    if (core->running_index == index) {
+        chargeGroup(core, process, core->now - process->last_run_time);
+    }
+    leaveShare(core, process);
+    recordBurst(core, process->bursts[process->burst_index]);
+    observeBurst(core, process);
+
+    // Settle any waiting time still outstanding
+    process->waiting_time = currentWaitingTime(core, process);
+    process->ready_since = -1;
+
+    setProcessState(core->table, index, FINISHED);
+    process->finish_time = core->now;
+    process->remaining_time = 0;
+
+    // Calculate statistics
+    int turnaround = process->finish_time - process->arrival_time;
+    double weighted_turnaround = (double)turnaround / process->runtime;
+
+    core->turnaround_times[core->finished_count] = turnaround;
+    core->weighted_turnaround_times[core->finished_count] = weighted_turnaround;
+    core->finished_count++;
+    core->total_finished_waiting += process->waiting_time;
+    core->total_finished_wta += weighted_turnaround;
+
+    notify(core, EVENT_FINISH, index);
+
+    // If this was the running process, the CPU is free now
+    if (core->running_index == index) {
+        core->running_index = -1;
+        cancelTimer(core->timers, &core->quantum_timer);
+        cancelTimer(core->timers, &core->burst_timer);
+    }
+
+    if (core->has_deps) releaseChildren(core, dependencyNode(core, process->id));
+
+    schedSchedule(core);
+}
+
+// Function to give the CPU to a process
+static void runProcess(SchedCore* core, int index) {
+    updateWaitingTimes(core);
+
+    // Settle the time spent in the ready queue
+    Process* process = &core->table->records[index];
+    process->waiting_time = currentWaitingTime(core, process);
+    process->ready_since = -1;
+
+    bool resumed = process->start_time != -1;
+    if (!resumed) {
+        process->start_time = core->now;
+    }
+    setProcessState(core->table, index, RUNNING);
+    process->last_run_time = core->now;
+    core->running_index = index;
+    core->dispatches++;
+
+    notify(core, resumed ? EVENT_RESUME : EVENT_DISPATCH, index);
+
+    // The burst ends on its own timer unless the caller reports it; a
+    // time-sliced policy also stops the process when its quantum runs out.
+    // The burst timer goes first so a burst ending right at the quantum
+    // boundary finishes instead of being stopped.
+    process = &core->table->records[index];
+    if (!core->external_bursts) {
+        core->burst_timer.data = index;
+        addTimer(core->timers, &core->burst_timer, core->now + process->burst_remaining);
+    }
+    if (policyOf(core)->time_sliced) {
+        core->quantum_timer.data = index;
+        addTimer(core->timers, &core->quantum_timer, core->now + sliceLength(core, process));
+    }
+}
+
+// Function to take the CPU from the running process and put it back in the
+// ready queue
+static void stopProcess(SchedCore* core, int index) {
+    updateWaitingTimes(core);
+    cancelTimer(core->timers, &core->quantum_timer);
+    cancelTimer(core->timers, &core->burst_timer);
+
+    Process* process = &core->table->records[index];
+    int ran = core->now - process->last_run_time;
+    const SchedPolicy* policy = policyOf(core);
+    chargeGroup(core, process, ran);
+    if (policy->onPreempt != NULL) {
+        policy->onPreempt(core, process, ran);
+    }
+
+    setProcessState(core->table, index, STOPPED);
+    process->ready_since = core->now;
+    process->remaining_time -= ran;
+    process->burst_remaining -= ran;
+    if (process->remaining_time < 0) process->remaining_time = 0;
+    if (process->burst_remaining < 0) process->burst_remaining = 0;
+    process->prempted = true;
+    core->preemptions++;
+    core->running_index = -1;
+
+    notify(core, EVENT_PREEMPT, index);
+
+    // Put the process back behind any I/O completion that happened while it ran
+    checkIoCompletions(core);
+    schedEnqueue(core, index);
+
+    schedSchedule(core);
+}
+
+// Function to dispatch the process the policy picks, or to preempt the running
+// process if the policy says a ready one should displace it
+void schedSchedule(SchedCore* core) {
+    updateWaitingTimes(core);
+
+    const SchedPolicy* policy = policyOf(core);
+    long long queue_start = monotonicNs();
+    if (core->running_index != -1) {
+        Process* running = &core->table->records[core->running_index];
+        bool preempt = policy->preempts != NULL && policy->preempts(core, running);
+        recordLatency(&core->queue_latency, monotonicNs() - queue_start);
+
+        // stopProcess() requeues the running process and reschedules, which
+        // picks the process that displaced it
+        if (preempt) {
+            stopProcess(core, core->running_index);
+        }
+        return;
+    }
+
+    int next = policy->pickNext(core);
+    recordLatency(&core->queue_latency, monotonicNs() - queue_start);
+
+    if (next >= 0 && next < core->table->count) {
+        runProcess(core, next);
+    }
+}
+
+// Function to handle a timer that expired on the core's wheel
+static void fireCoreTimer(Timer* timer) {
+    SchedCore* core = coreOfTimer(timer);
+    int index = core->running_index;
+
+    // The timer fires at the tick it expires, however far the core is advanced
+    schedSetTime(core, core->timers->now);
+
+    if (timer->type == TIMER_BURST) {
+        if (index == timer->data) {
+            schedCompleteBurst(core, index);
+        }
+    } else if (timer->type == TIMER_QUANTUM) {
+        if (index != timer->data) return;
+
+        // A burst that ends right at the quantum boundary is about to end;
+        // stopping it now would leave nothing to resume. An open-ended job
+        // may outrun its estimate, so it is stopped regardless.
+        Process* running = &core->table->records[index];
+        if (!running->open_ended && running->burst_remaining - (core->now - running->last_run_time) <= 0) return;
+
+        stopProcess(core, index);
+    } else if (timer->type == TIMER_IO) {
+        if (checkIoCompletions(core) > 0) {
+            schedSchedule(core);
+        }
+    }
+}
+
+// Function to advance the core to now, ending bursts, quanta and I/O that fall
+// due on the way in time order, each at its own expiry time. Returns the
+// number of timers fired.
+int schedAdvance(SchedCore* core, int now) {
+    if (now < core->now) now = core->now;
+
+    const SchedPolicy* policy = policyOf(core);
+    int fired = 0;
+    if (policy->onTick != NULL) {
+        // The policy looks at the running process once per tick
+        while (core->timers->now < now) {
+            fired += advanceTimerWheel(core->timers, core->timers->now + 1, fireCoreTimer);
+            schedSetTime(core, core->timers->now);
+            int index = core->running_index;
+            if (index != -1 && policy->onTick(core, &core->table->records[index])) {
+                stopProcess(core, index);
+            }
+        }
+    }
+    fired += advanceTimerWheel(core->timers, now, fireCoreTimer);
+    schedSetTime(core, now);
+    return fired;
+}
+
+// Function to report what holds the CPU and when the next timer falls due
+void schedNextDispatch(const SchedCore* core, SchedDispatch* dispatch) {
+    dispatch->index = core->running_index;
+    dispatch->id = -1;
+    dispatch->since = -1;
+    if (core->running_index != -1) {
+        dispatch->id = core->table->records[core->running_index].id;
+        dispatch->since = core->table->records[core->running_index].last_run_time;
+    }
+
+    dispatch->next_event = -1;
+    const Timer* timers[] = { &core->quantum_timer, &core->burst_timer, &core->io_timer };
+    for (int i = 0; i < 3; i++) {
+        if (timers[i]->pending && (dispatch->next_event == -1 || timers[i]->expires < dispatch->next_event)) {
+            dispatch->next_event = timers[i]->expires;
+        }
+    }
+
+    // A policy that looks at the running process every tick may preempt it at
+    // the next one while others are ready
+    if (policyOf(core)->onTick != NULL && core->running_index != -1 && readyQueueSize((SchedCore*)core) > 0) {
+        if (dispatch->next_event == -1 || core->now + 1 < dispatch->next_event) {
+            dispatch->next_event = core->now + 1;
+        }
+    }
+}
+
+// Function to read the counters behind the statistics page
+void schedGetStats(const SchedCore* core, SchedCoreStats* stats) {
+    stats->now = core->now;
+    stats->jobs = core->table->count;
+    stats->finished = core->finished_count;
+    stats->ready = core->table->state_count[READY] + core->table->state_count[STOPPED];
+    stats->blocked = core->table->state_count[BLOCKED];
+    stats->pending = core->table->state_count[PENDING];
+    stats->dispatches = core->dispatches;
+    stats->preemptions = core->preemptions;
+    stats->cpu_utilization = core->total_runtime > 0 ?
+        100.0 * (core->total_runtime - core->idle_time) / core->total_runtime : 0;
+    stats->device_utilization = core->total_runtime > 0 ?
+        100.0 * deviceBusyTime(core) / core->total_runtime : 0;
+    stats->avg_waiting = core->finished_count > 0 ? core->total_finished_waiting / core->finished_count : 0;
+    stats->avg_wta = core->finished_count > 0 ? core->total_finished_wta / core->finished_count : 0;
+}
+
+// Function to get the id of the job in a slot, -1 for an unused slot
+int schedJobId(const SchedCore* core, int index) {
+    if (index < 0 || index >= core->table->count) return -1;
+    return core->table->records[index].id;
+}
+
+// Function to compare the CPU time each process got with the time its ticket
+// share entitled it to while it was runnable
+void reportShares(SchedCore* core, FILE* file) {
+    double total_error = 0;
+    double max_error = 0;
+    int counted = 0;
+    for (int i = 0; i < core->table->count; i++) {
+        Process* process = &core->table->records[i];
+        if (process->state != FINISHED || process->entitled_time <= 0) continue;
+        double error = 100.0 * fabs(process->runtime - process->entitled_time) / process->entitled_time;
+        total_error += error;
+        if (error > max_error) max_error = error;
+        counted++;
+    }
+
+    fprintf(file, "Avg share error = %.2f%%\n", counted > 0 ? total_error / counted : 0);
+    fprintf(file, "Max share error = %.2f%%\n", max_error);
+
+    fprintf(file, "\nCPU share per process:\n");
+    fprintf(file, "%8s %8s %10s %10s %8s\n", "id", "tickets", "entitled", "actual", "error");
+    for (int i = 0; i < core->table->count; i++) {
+        Process* process = &core->table->records[i];
+        if (process->state != FINISHED) continue;
+        double error = process->entitled_time > 0 ?
+            100.0 * (process->runtime - process->entitled_time) / process->entitled_time : 0;
+        fprintf(file, "%8d %8d %10.2f %10d %+7.1f%%\n", process->id, process->tickets,
+                process->entitled_time, process->runtime, error);
+    }
+}
+
+// Function to report how the adaptive quantum moved during the run
+void reportQuantum(SchedCore* core, FILE* file) {
+    fprintf(file, "Adaptive quantum = p%d of the last %d CPU bursts\n", core->quantum_percentile, QUANTUM_WINDOW);
+    fprintf(file, "Avg slice = %.2f\n", core->slice_count > 0 ? (double)core->slice_total / core->slice_count : 0);
+    fprintf(file, "Min slice = %d\n", core->slice_count > 0 ? core->slice_min : 0);
+    fprintf(file, "Max slice = %d\n", core->slice_max);
+
+    fprintf(file, "\nQuantum over time:\n");
+    fprintf(file, "%8s %8s %8s\n", "time", "quantum", "ready");
+    for (int i = 0; i < core->quantum_sample_count; i++) {
+        fprintf(file, "%8d %8d %8d\n", core->quantum_samples[i].time, core->quantum_samples[i].quantum,
+                core->quantum_samples[i].ready);
+    }
+}
+
+// Function to report how well bursts were predicted and what the predictions
+// cost against SRTN knowing every runtime. The oracle is a virtual-time replay
+// of the same arrivals through a core of its own (see sim.c).
+void reportPrediction(SchedCore* core, FILE* file, double avg_wta) {
+    long samples = 0;
+    double abs_error = 0;
+    for (int priority = 0; priority <= MAX_PRIORITY; priority++) {
+        samples += core->prediction_count[priority];
+        abs_error += core->prediction_abs_error[priority];
+    }
+
+    fprintf(file, "Burst prediction = exponential average per priority, alpha %.2f\n", PREDICTION_ALPHA);
+    fprintf(file, "Predicted bursts = %ld\n", samples);
+    fprintf(file, "Mean abs prediction error = %.2f\n", samples > 0 ? abs_error / samples : 0);
+    fprintf(file, "Mean prediction bias = %+.2f\n", samples > 0 ? core->prediction_bias / samples : 0);
+    fprintf(file, "Mean relative prediction error = %.2f%%\n",
+            samples > 0 ? 100.0 * core->prediction_rel_error / samples : 0);
+
+    SimResult oracle;
+    if (simulateTrace(core->table->records, core->table->count, SRTN, 0, &oracle) == 0) {
+        fprintf(file, "Oracle SRTN WTA = %.2f\n", oracle.avg_wta);
+        fprintf(file, "WTA lost to prediction = %.2f (%+.1f%%)\n", avg_wta - oracle.avg_wta,
+                oracle.avg_wta > 0 ? 100.0 * (avg_wta - oracle.avg_wta) / oracle.avg_wta : 0);
+    }
+
+    fprintf(file, "\nPrediction per priority class:\n");
+    fprintf(file, "%8s %8s %10s %10s\n", "priority", "bursts", "estimate", "abs_error");
+    for (int priority = 0; priority <= MAX_PRIORITY; priority++) {
+        if (core->prediction_count[priority] == 0) continue;
+        fprintf(file, "%8d %8ld %10.2f %10.2f\n", priority, core->prediction_count[priority],
+                core->class_estimate[priority],
+                core->prediction_abs_error[priority] / core->prediction_count[priority]);
+    }
+}
+
+// Function to compare the CPU time and turnaround of each group with its
+// weight; a group's share of the CPU only follows its weight while every
+// group has work ready
+void reportGroups(SchedCore* core, FILE* file) {
+    int count = core->group_count;
+    long* cpu = calloc(count, sizeof(long));
+    int* jobs = calloc(count, sizeof(int));
+    int* finished = calloc(count, sizeof(int));
+    double* wta = calloc(count, sizeof(double));
+    double* waiting = calloc(count, sizeof(double));
+    long total_weight = 0;
+    long busy = 0;
+
+    for (int g = 0; g < count; g++) {
+        total_weight += core->groups[g].weight;
+    }
+    for (int i = 0; i < core->table->count; i++) {
+        Process* process = &core->table->records[i];
+        int g = process->group;
+        long used = process->runtime - currentRemainingTime(core, process);
+        jobs[g]++;
+        cpu[g] += used;
+        busy += used;
+        if (process->state == FINISHED) {
+            finished[g]++;
+            wta[g] += (double)(process->finish_time - process->arrival_time) / process->runtime;
+            waiting[g] += process->waiting_time;
+        }
+    }
+
+    fprintf(file, "\nGroups:\n");
+    fprintf(file, "%-16s %6s %6s %8s %8s %8s %8s %8s %8s\n", "group", "weight", "jobs", "finished",
+            "cpu_time", "cpu_util", "share", "avg_wta", "avg_wait");
+    for (int g = 0; g < count; g++) {
+        fprintf(file, "%-16s %6d %6d %8d %8ld %7.2f%% %7.2f%% %8.2f %8.2f\n", core->groups[g].name,
+                core->groups[g].weight, jobs[g], finished[g], cpu[g],
+                core->total_runtime > 0 ? 100.0 * cpu[g] / core->total_runtime : 0,
+                busy > 0 ? 100.0 * cpu[g] / busy : 0,
+                finished[g] > 0 ? wta[g] / finished[g] : 0,
+                finished[g] > 0 ? waiting[g] / finished[g] : 0);
+    }
+    fprintf(file, "Share is the group's part of the CPU time used; weights entitle to");
+    for (int g = 0; g < count; g++) {
+        fprintf(file, " %s %.2f%%", core->groups[g].name, 100.0 * core->groups[g].weight / total_weight);
+    }
+    fprintf(file, "\n");
+
+    free(cpu);
+    free(jobs);
+    free(finished);
+    free(wta);
+    free(waiting);
+}
+
+// Function to compare two job ids
+static int compareIds(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Function to stop waiting for parents that will never arrive, such as jobs
+// the generator dropped; their children are released as if they had finished,
+// in order of the parents' ids
+void schedReleaseOrphans(SchedCore* core) {
+    updateWaitingTimes(core);
+    int* orphans = malloc((core->dep_count > 0 ? core->dep_count : 1) * sizeof(int));
+    if (!orphans) {
+        perror("Error allocating orphans");
+        exit(1);
+    }
+    size_t orphan_count = 0;
+    for (size_t i = 0; i < core->dep_capacity; i++) {
+        DependencyNode* node = &core->dep_nodes[i];
+        if (node->id != -1 && node->index == -1 && node->child_count > 0) {
+            orphans[orphan_count++] = node->id;
+        }
+    }
+    qsort(orphans, orphan_count, sizeof(int), compareIds);
+    for (size_t i = 0; i < orphan_count; i++) {
+        releaseChildren(core, findDependencyNode(core, orphans[i]));
+    }
+    free(orphans);
+    schedSchedule(core);
+}
+
+// Function to rebuild the dependency nodes and pending counts from the
+// process table, after a snapshot was restored into it
+void schedRebuildDependencies(SchedCore* core) {
+    for (int i = 0; i < core->table->count && !core->has_deps; i++) {
+        if (core->table->records[i].dep_count > 0) trackDependencies(core);
+    }
+    if (!core->has_deps) return;
+
+    for (int i = 0; i < core->table->count; i++) {
+        Process* process = &core->table->records[i];
+        if (process->state == FINISHED) continue;
+        process->indegree = 0;
+        for (int d = 0; d < process->dep_count; d++) {
+            DependencyNode* parent = dependencyNode(core, process->deps[d]);
+            if (!parent->finished) {
+                addChild(parent, i);
+                process->indegree++;
+            }
+        }
+    }
+}
+
+// Function to find the set a job belongs to, halving the path on the way
+static int findPipeline(int* parent, int index) {
+    while (parent[index] != index) {
+        parent[index] = parent[parent[index]];
+        index = parent[index];
+    }
+    return index;
+}
+
+// Function to report the makespan and how far each pipeline (set of jobs
+// connected by dependencies) ran behind its critical path. The critical path
+// counts CPU and I/O bursts with no waiting, so slack is the time lost to
+// queueing, the I/O device and jobs arriving late.
+void reportDependencies(SchedCore* core, FILE* file) {
+    int count = core->table->count;
+    int* parent = malloc((count > 0 ? count : 1) * sizeof(int));
+    for (int i = 0; i < count; i++) parent[i] = i;
+
+    // Join every job with the parents it waited for
+    for (int i = 0; i < count; i++) {
+        Process* process = &core->table->records[i];
+        for (int d = 0; d < process->dep_count; d++) {
+            int id = process->deps[d];
+            DependencyNode* node = findDependencyNode(core, id);
+            int p = node != NULL ? node->index : -1;
+            if (p != -1) parent[findPipeline(parent, i)] = findPipeline(parent, p);
+        }
+    }
+
+    int first_arrival = INT_MAX;
+    int last_finish = 0;
+    int critical_path = 0;
+    for (int i = 0; i < count; i++) {
+        Process* process = &core->table->records[i];
+        if (process->arrival_time < first_arrival) first_arrival = process->arrival_time;
+        if (process->finish_time > last_finish) last_finish = process->finish_time;
+        if (process->critical_path > critical_path) critical_path = process->critical_path;
+    }
+    if (count == 0) first_arrival = 0;
+
+    fprintf(file, "\nDependencies:\n");
+    fprintf(file, "Makespan = %d (first arrival %d, last finish %d)\n",
+            last_finish - first_arrival, first_arrival, last_finish);
+    fprintf(file, "Critical path = %d\n", critical_path);
+    fprintf(file, "Critical-path slack = %d\n", last_finish - first_arrival - critical_path);
+
+    // One line per pipeline, named after its first job in the table; the
+    // figures are gathered at the pipeline's root in a single pass
+    int* jobs = calloc(count > 0 ? count : 1, sizeof(int));
+    int* start = malloc((count > 0 ? count : 1) * sizeof(int));
+    int* end = calloc(count > 0 ? count : 1, sizeof(int));
+    int* critical = calloc(count > 0 ? count : 1, sizeof(int));
+    int* first_id = malloc((count > 0 ? count : 1) * sizeof(int));
+    bool* done = malloc((count > 0 ? count : 1) * sizeof(bool));
+    for (int i = 0; i < count; i++) {
+        int root = findPipeline(parent, i);
+        Process* process = &core->table->records[i];
+        if (jobs[root]++ == 0) {
+            start[root] = process->arrival_time;
+            first_id[root] = process->id;
+            done[root] = true;
+        }
+        if (process->arrival_time < start[root]) start[root] = process->arrival_time;
+        if (process->finish_time > end[root]) end[root] = process->finish_time;
+        if (process->critical_path > critical[root]) critical[root] = process->critical_path;
+        if (process->state != FINISHED) done[root] = false;
+    }
+
+    fprintf(file, "\nPipelines:\n");
+    fprintf(file, "%8s %6s %8s %8s %8s %8s %8s\n", "first_id", "jobs", "start", "end", "latency",
+            "critical", "slack");
+    int pipelines = 0;
+    long total_latency = 0;
+    long total_slack = 0;
+    for (int root = 0; root < count; root++) {
+        if (jobs[root] < 2 || !done[root]) continue;
+
+        int latency = end[root] - start[root];
+        pipelines++;
+        total_latency += latency;
+        total_slack += latency - critical[root];
+        fprintf(file, "%8d %6d %8d %8d %8d %8d %8d\n", first_id[root], jobs[root], start[root], end[root],
+                latency, critical[root], latency - critical[root]);
+    }
+    if (pipelines > 0) {
+        fprintf(file, "Avg pipeline latency = %.2f, avg slack = %.2f over %d pipelines\n",
+                (double)total_latency / pipelines, (double)total_slack / pipelines, pipelines);
+    }
+
+    free(parent);
+    free(jobs);
+    free(start);
+    free(end);
+    free(critical);
+    free(first_id);
+    free(done);
+}
+
+void schedDestroy(SchedCore* core) {
+    if (core == NULL) return;
+    policyOf(core)->destroy(core);
+    destroyProcessTable(core->table);
+    destroyCircularQueue(core->io_queue);
+    destroyTimerWheel(core->timers);
+    free(core->turnaround_times);
+    free(core->weighted_turnaround_times);
+    free(core->quantum_samples);
+    free(core->groups);
+    for (size_t i = 0; i < core->dep_capacity; i++) {
+        if (core->dep_nodes[i].id != -1) free(core->dep_nodes[i].children);
+    }
+    free(core->dep_nodes);
+    free(core);
+}
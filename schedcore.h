@@ -0,0 +1,120 @@
+#ifndef SCHEDCORE_H
+#define SCHEDCORE_H
+
+#include <stdbool.h>
+
+// Embeddable scheduling core (libsched.a / libsched.so). A SchedCore holds one
+// independent scheduler: the jobs submitted to it, the ready queue of its
+// policy, a single FCFS I/O device and the accounting behind the statistics.
+// Time is whatever the caller says it is; nothing here sleeps, forks or uses
+// IPC, so a decision costs about a microsecond. The scheduler binary is a
+// wrapper that drives a core from the clock process and runs its dispatches
+// as real processes.
+
+// Define scheduling algorithms
+#define HPF 1
+#define SRTN 2
+#define RR 3
+#define LOTTERY 4
+#define STRIDE 5
+#define PSRTN 6      // SRTN on predicted burst lengths instead of the trace runtimes
+#define FAIR_HPF 7   // Hierarchical fair share: stride across groups, HPF inside each
+#define FAIR_SRTN 8  // ... SRTN inside each group
+#define FAIR_RR 9    // ... RR inside each group
+#define CRITICAL_PATH 10 // Ready job with the longest path to the end of its DAG first
+#define ALGORITHM_COUNT 10
+
+// A quantum of ADAPTIVE_QUANTUM makes a time-sliced policy derive it from
+// the CPU bursts that completed recently and from the ready queue length
+#define ADAPTIVE_QUANTUM 0
+
+// Priority 0 is the highest
+#define MAX_PRIORITY 10
+
+// A job alternates CPU and I/O bursts: bursts[0], bursts[2], ... are CPU bursts
+// and bursts[1], bursts[3], ... are I/O bursts; the last burst is always CPU
+#define MAX_BURSTS 16
+
+// Every job belongs to a group (a user or tenant); jobs without one share the
+// group DEFAULT_GROUP. Under the FAIR_ algorithms groups get CPU time in
+// proportion to their weight, which the first job of a group sets.
+#define MAX_GROUP_NAME 16
+#define DEFAULT_GROUP "default"
+
+// A job may depend on up to MAX_DEPS others by id; it stays pending until the
+// last of them has finished
+#define MAX_DEPS 8
+
+// Define trace event types; the core reports the same events to its callback
+#define EVENT_ARRIVAL 1
+#define EVENT_DISPATCH 2
+#define EVENT_PREEMPT 3
+#define EVENT_RESUME 4
+#define EVENT_FINISH 5
+#define EVENT_QUEUE_DEPTH 6
+#define EVENT_BLOCK 7
+#define EVENT_IO_DONE 8
+#define EVENT_RELEASE 9      // Last parent of a pending job finished
+
+typedef struct SchedCore SchedCore;
+
+// A job handed to schedSubmit(); it arrives at the core's current time. Work
+// done at a time t before the core is advanced to t comes first: a job
+// submitted after schedSetTime(core, t) but before schedAdvance(core, t)
+// queues ahead of a process whose quantum ends at t, and one submitted after
+// schedAdvance(core, t) queues behind it. The scheduler binary takes the
+// first order, handing over the arrivals of a tick before advancing the core.
+typedef struct {
+    int id;                  // Not negative
+    int priority;
+    int runtime;             // CPU time of a job without I/O
+    int burst_count;         // 0 for a job without I/O, else the entries used in bursts
+    int bursts[MAX_BURSTS];
+    char group[MAX_GROUP_NAME]; // Empty for DEFAULT_GROUP
+    int group_weight;        // 0 for a weight of 1
+    int dep_count;
+    int deps[MAX_DEPS];      // Ids of the jobs that must finish first
+    int critical_path;       // Longest path from the job to the end of its DAG, 0 for its own length
+} SchedJob;
+
+// What holds the CPU, and until when nothing changes unless a job is submitted
+typedef struct {
+    int id;                  // Running job, -1 while the CPU is idle
+    int index;               // Its slot, as returned by schedSubmit()
+    int since;               // Time it was dispatched
+    int next_event;          // Next quantum end, burst end or I/O completion, or the next
+                             // tick while the policy may preempt on any tick; -1 if none
+} SchedDispatch;
+
+typedef struct {
+    int now;
+    int jobs;
+    int finished;
+    int ready;
+    int blocked;
+    int pending;             // Waiting for the jobs they depend on
+    long dispatches;
+    long preemptions;
+    double cpu_utilization;      // Percent of the time so far
+    double device_utilization;
+    double avg_waiting;          // Over finished jobs
+    double avg_wta;
+} SchedCoreStats;
+
+// Called for every state change, with one of the EVENT_ types and the slot of
+// the job concerned. It may read the core but must not change it.
+typedef void (*SchedEventCallback)(void* context, int type, int index);
+
+// Function declarations for the scheduling core (see schedcore.c)
+SchedCore* schedCreate(int algorithm, int quantum);
+void schedSetCallback(SchedCore* core, SchedEventCallback callback, void* context);
+int schedSubmit(SchedCore* core, const SchedJob* job);
+void schedSetTime(SchedCore* core, int now);
+int schedAdvance(SchedCore* core, int now);
+void schedNextDispatch(const SchedCore* core, SchedDispatch* dispatch);
+void schedGetStats(const SchedCore* core, SchedCoreStats* stats);
+void schedReleaseOrphans(SchedCore* core);
+int schedJobId(const SchedCore* core, int index);
+void schedDestroy(SchedCore* core);
+
+#endif
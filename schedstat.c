@@ -0,0 +1,73 @@
+#include "headers.h"
+
+// Function to take a consistent copy of the statistics page without locking
+void readStats(const SchedStats *page, SchedStats *out) {
+    unsigned int seq;
+    do {
+        // Wait for any update in progress to complete
+        while ((seq = page->seq) & 1) {
+            usleep(1000);
+        }
+        __sync_synchronize();
+        memcpy(out, (const void *)page, sizeof(SchedStats));
+        __sync_synchronize();
+    } while (page->seq != seq);
+}
+
+int main(int argc, char *argv[]) {
+    int interval_ms = 1000;
+    int count = 0; // 0 means sample until the scheduler exits
+
+    if (argc > 1) interval_ms = atoi(argv[1]);
+    if (argc > 2) count = atoi(argv[2]);
+    if (interval_ms <= 0) {
+        printf("Usage: %s [interval_ms] [count]\n", argv[0]);
+        exit(1);
+    }
+
+    // Find the page of the instance started from this directory, unless the
+    // environment names one explicitly
+    int stats_shm_id = getenv(ENV_STATS_SHM) != NULL ? getIpcId(ENV_STATS_SHM)
+                                                     : readInstanceId(INSTANCE_FILE, ENV_STATS_SHM);
+    if (stats_shm_id == -1) {
+        printf("Error: no %s here and %s is not set (is the simulation running?)\n",
+               INSTANCE_FILE, ENV_STATS_SHM);
+        exit(1);
+    }
+
+    SchedStats *page = (SchedStats *)shmat(stats_shm_id, NULL, SHM_RDONLY);
+    if ((void *)page == (void *)-1) {
+        perror("Error attaching statistics page");
+        exit(1);
+    }
+
+    SchedStats stats;
+    for (int i = 0; count == 0 || i < count; i++) {
+        readStats(page, &stats);
+
+        printf("time=%d alg=%d quantum=%d jobs=%d finished=%d running=%d blocked=%d "
+               "q_hpf=%d q_srtn=%d q_rr=%d q_lottery=%d q_stride=%d q_psrtn=%d q_fair_hpf=%d q_fair_srtn=%d q_fair_rr=%d q_cp=%d "
+               "dispatches=%ld preemptions=%ld "
+               "dispatch_rate=%d cpu_util=%.2f device_util=%.2f avg_wait=%.2f avg_wta=%.2f\n",
+               stats.current_time, stats.algorithm, stats.quantum,
+               stats.process_count, stats.finished_count, stats.running_id, stats.blocked_count,
+               stats.queue_depth[HPF], stats.queue_depth[SRTN], stats.queue_depth[RR],
+               stats.queue_depth[LOTTERY], stats.queue_depth[STRIDE], stats.queue_depth[PSRTN],
+               stats.queue_depth[FAIR_HPF], stats.queue_depth[FAIR_SRTN], stats.queue_depth[FAIR_RR],
+               stats.queue_depth[CRITICAL_PATH],
+               stats.dispatches, stats.preemptions, stats.dispatches_per_sec,
+               stats.cpu_utilization, stats.device_utilization, stats.avg_waiting, stats.avg_wta);
+        fflush(stdout);
+
+        // Stop once the simulation has detached and only we are left
+        struct shmid_ds info;
+        if (shmctl(stats_shm_id, IPC_STAT, &info) == -1 || info.shm_nattch <= 1) {
+            break;
+        }
+
+        usleep(interval_ms * 1000);
+    }
+
+    shmdt(page);
+    return 0;
+}
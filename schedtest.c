@@ -0,0 +1,954 @@
+#include "headers.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+// Regression tests for the scheduling core and the binaries around it. The
+// core tests drive a SchedCore through its API and check the decisions it
+// made. The end-to-end tests run process_generator on a small trace in a
+// scratch directory under RUN_BASE, like sweep does, and read the logs the
+// run leaves; they take a few clock seconds each and -c skips them. A failed
+// check prints where it failed. The exit status is the number of tests that
+// failed.
+
+#define RUN_BASE "schedtest.runs"
+
+typedef struct {
+    const char* name;
+    void (*run)();
+    bool end_to_end;
+} SchedTest;
+
+int checks_failed = 0;
+
+// Function to record one check, printing it when it fails
+void check(bool ok, const char* condition, const char* test, int line) {
+    if (ok) return;
+    checks_failed++;
+    printf("  %s:%d: %s failed\n", test, line, condition);
+}
+
+#define CHECK(condition) check((condition), #condition, __func__, __LINE__)
+
+// Function to describe a job without I/O for schedSubmit()
+SchedJob cpuJob(int id, int priority, int runtime) {
+    SchedJob job;
+    memset(&job, 0, sizeof(job));
+    job.id = id;
+    job.priority = priority;
+    job.runtime = runtime;
+    return job;
+}
+
+// Function to submit a job without I/O, returning its slot
+int submitJob(SchedCore* core, int id, int priority, int runtime) {
+    SchedJob job = cpuJob(id, priority, runtime);
+    return schedSubmit(core, &job);
+}
+
+// The running process is tracked by its table index, so growing the table
+// while it runs must not lose it
+void testRunningSurvivesTableGrowth() {
+    SchedCore* core = schedCreate(HPF, 0);
+    int first = submitJob(core, 1, 0, 50);
+    schedAdvance(core, 1);
+    for (int id = 2; id <= 1000; id++) {
+        submitJob(core, id, 5, 1);
+    }
+    CHECK(core->table->capacity >= 1000);
+
+    SchedDispatch dispatch;
+    schedNextDispatch(core, &dispatch);
+    CHECK(dispatch.id == 1);
+    CHECK(dispatch.index == first);
+    CHECK(dispatch.next_event == 50);
+
+    schedAdvance(core, 50);
+    CHECK(core->table->records[first].state == FINISHED);
+    CHECK(core->table->records[first].finish_time == 50);
+    schedDestroy(core);
+}
+
+// Both waitpid() and the termination message report a process's exit, and
+// pids are reused; only an unfinished process may match a reported pid
+void testDuplicateTerminationIgnored() {
+    ProcessTable* table = createProcessTable(2);
+    Process process;
+    memset(&process, 0, sizeof(process));
+    process.state = RUNNING;
+    process.pid = 42;
+    int first = addProcessToTable(table, process);
+    CHECK(findProcessByPid(table, 42) == first);
+
+    // The second report of the same exit finds nothing
+    setProcessState(table, first, FINISHED);
+    CHECK(findProcessByPid(table, 42) == -1);
+
+    // A later process given the same pid is the one reported
+    int second = addProcessToTable(table, process);
+    CHECK(findProcessByPid(table, 42) == second);
+    destroyProcessTable(table);
+}
+
+// The queues were fixed at 100 entries and dropped what did not fit; they now
+// grow, a wrapped circular queue keeping its FIFO order
+void testQueuesGrow() {
+    CircularQueue* queue = createCircularQueue(4);
+    enqueueCircularQueue(queue, 0);
+    enqueueCircularQueue(queue, 1);
+    dequeueCircularQueue(queue);
+    for (int i = 2; i < 1000; i++) {
+        enqueueCircularQueue(queue, i);
+    }
+    CHECK(queue->size == 999);
+    bool fifo = true;
+    for (int i = 1; i < 1000; i++) {
+        if (dequeueCircularQueue(queue) != i) fifo = false;
+    }
+    CHECK(fifo);
+    destroyCircularQueue(queue);
+
+    PriorityQueue* pq = createPriorityQueue(4);
+    Process process;
+    memset(&process, 0, sizeof(process));
+    for (int i = 0; i < 1000; i++) {
+        process.table_index = i;
+        insertPriorityQueue(pq, (i * 7919) % 1000, &process);
+    }
+    CHECK(pq->size == 1000);
+    bool ordered = true;
+    for (int i = 0; i < 1000; i++) {
+        if (removePriorityQueue(pq).key != i) ordered = false;
+    }
+    CHECK(ordered);
+    destroyPriorityQueue(pq);
+}
+
+// Function to advance a core from event to event until nothing is pending
+void runToEnd(SchedCore* core) {
+    SchedDispatch dispatch;
+    schedNextDispatch(core, &dispatch);
+    while (dispatch.next_event != -1) {
+        schedAdvance(core, dispatch.next_event);
+        schedNextDispatch(core, &dispatch);
+    }
+}
+
+// Events a core reported, for the tests that check its decisions
+typedef struct {
+    SchedCore* core;
+    int dispatches;
+    int preemptions;
+    int max_running;       // Most processes ever RUNNING at once
+    int order[64];         // Job ids in the order they got the CPU
+} EventLog;
+
+// Function to record the events of a core into an EventLog
+void logEvent(void* context, int type, int index) {
+    EventLog* log = context;
+    int running = log->core->table->state_count[RUNNING];
+    if (running > log->max_running) log->max_running = running;
+
+    if (type == EVENT_DISPATCH || type == EVENT_RESUME) {
+        if (log->dispatches < 64) log->order[log->dispatches] = schedJobId(log->core, index);
+        log->dispatches++;
+    } else if (type == EVENT_PREEMPT) {
+        log->preemptions++;
+    }
+}
+
+// Function to create a core that records its events into log
+SchedCore* loggedCore(int algorithm, int quantum, EventLog* log) {
+    memset(log, 0, sizeof(EventLog));
+    log->core = schedCreate(algorithm, quantum);
+    schedSetCallback(log->core, logEvent, log);
+    return log->core;
+}
+
+// Advancing a core far past several timers in one call fires each at its own
+// expiry: it gives the same run as stepping from event to event, or tick by
+// tick as the scheduler binary does
+void testOneAdvanceMatchesStepping() {
+    int runtimes[] = { 9, 2, 7, 3, 5, 4 };
+    for (int alg = HPF; alg <= ALGORITHM_COUNT; alg++) {
+        SchedCore* stepped = schedCreate(alg, 2);
+        SchedCore* ticked = schedCreate(alg, 2);
+        SchedCore* jumped = schedCreate(alg, 2);
+        for (int i = 0; i < 6; i++) {
+            submitJob(stepped, i + 1, i % 3, runtimes[i]);
+            submitJob(ticked, i + 1, i % 3, runtimes[i]);
+            submitJob(jumped, i + 1, i % 3, runtimes[i]);
+        }
+        runToEnd(stepped);
+        for (int tick = 1; tick <= 100; tick++) {
+            schedAdvance(ticked, tick);
+        }
+        schedAdvance(jumped, 100);
+
+        CHECK(jumped->now == 100);
+        for (int i = 0; i < 6; i++) {
+            CHECK(jumped->table->records[i].finish_time == stepped->table->records[i].finish_time);
+            CHECK(ticked->table->records[i].finish_time == stepped->table->records[i].finish_time);
+        }
+        CHECK(jumped->dispatches == stepped->dispatches);
+        CHECK(ticked->dispatches == stepped->dispatches);
+        CHECK(jumped->total_finished_waiting == stepped->total_finished_waiting);
+        schedDestroy(stepped);
+        schedDestroy(ticked);
+        schedDestroy(jumped);
+    }
+
+    // With arrivals in between, stepping from event to event must also stop
+    // at every tick a policy may preempt on (PSRTN re-checks each tick)
+    for (int alg = HPF; alg <= ALGORITHM_COUNT; alg++) {
+        SchedCore* stepped = schedCreate(alg, 2);
+        SchedCore* ticked = schedCreate(alg, 2);
+        unsigned int seed = 3;
+        int arrival = 0;
+        for (int i = 0; i < 300; i++) {
+            int priority = rand_r(&seed) % 11;
+            int runtime = 1 + rand_r(&seed) % 12;
+            SchedDispatch dispatch;
+            schedNextDispatch(stepped, &dispatch);
+            while (dispatch.next_event != -1 && dispatch.next_event < arrival) {
+                schedAdvance(stepped, dispatch.next_event);
+                schedNextDispatch(stepped, &dispatch);
+            }
+            for (int tick = ticked->timers->now + 1; tick < arrival; tick++) {
+                schedAdvance(ticked, tick);
+            }
+            schedSetTime(stepped, arrival);
+            schedSetTime(ticked, arrival);
+            submitJob(stepped, i + 1, priority, runtime);
+            submitJob(ticked, i + 1, priority, runtime);
+            arrival += rand_r(&seed) % 8;
+        }
+        runToEnd(stepped);
+        for (int tick = ticked->timers->now + 1; tick <= stepped->now; tick++) {
+            schedAdvance(ticked, tick);
+        }
+        bool same = ticked->finished_count == 300 && ticked->dispatches == stepped->dispatches;
+        for (int i = 0; i < 300; i++) {
+            if (ticked->table->records[i].finish_time != stepped->table->records[i].finish_time) same = false;
+        }
+        if (!same) printf("  algorithm %d differs\n", alg);
+        CHECK(same);
+        schedDestroy(stepped);
+        schedDestroy(ticked);
+    }
+
+    SchedCore* core = schedCreate(HPF, 0);
+    int first = submitJob(core, 1, 0, 5);
+    int second = submitJob(core, 2, 0, 5);
+    schedAdvance(core, 100);
+    CHECK(core->table->records[first].finish_time == 5);
+    CHECK(core->table->records[second].finish_time == 10);
+    schedDestroy(core);
+}
+
+// An SRTN arrival with less left preempts the running process, and only the
+// shorter process may be dispatched, not both
+void testSrtnPreemptionDispatchesOne() {
+    EventLog log;
+    SchedCore* core = loggedCore(SRTN, 0, &log);
+    submitJob(core, 1, 0, 10);
+    schedAdvance(core, 2);
+    submitJob(core, 2, 0, 3);
+    schedAdvance(core, 3);
+    submitJob(core, 3, 0, 1);
+    runToEnd(core);
+
+    CHECK(log.max_running == 1);
+    CHECK(log.preemptions == 2);
+    CHECK(log.dispatches == 5);
+    CHECK(log.order[0] == 1 && log.order[1] == 2 && log.order[2] == 3);
+    CHECK(log.order[3] == 2 && log.order[4] == 1);
+
+    SchedCoreStats stats;
+    schedGetStats(core, &stats);
+    CHECK(stats.finished == 3);
+    schedDestroy(core);
+}
+
+// SRTN compares an arrival against what the running process has left now,
+// not at its dispatch: job 1 has 6 of its 10 left when job 2 needs 7
+void testSrtnComparesRunningSlice() {
+    EventLog log;
+    SchedCore* core = loggedCore(SRTN, 0, &log);
+    int first = submitJob(core, 1, 0, 10);
+    schedAdvance(core, 4);
+    submitJob(core, 2, 0, 7);
+    runToEnd(core);
+
+    CHECK(log.preemptions == 0);
+    CHECK(log.dispatches == 2);
+    CHECK(log.order[0] == 1 && log.order[1] == 2);
+    CHECK(core->table->records[first].finish_time == 10);
+    schedDestroy(core);
+}
+
+// A job submitted at the instant a quantum expires queues ahead of the
+// preempted process when it is submitted before the core is advanced to that
+// instant, as the scheduler binary does, and behind it when submitted after
+void testRrArrivalBeforeQuantumEnd() {
+    EventLog log;
+    SchedCore* core = loggedCore(RR, 2, &log);
+    submitJob(core, 1, 0, 4);
+    schedSetTime(core, 2);
+    submitJob(core, 2, 0, 2);
+    runToEnd(core);
+    CHECK(log.dispatches == 3);
+    CHECK(log.order[0] == 1 && log.order[1] == 2 && log.order[2] == 1);
+    schedDestroy(core);
+
+    core = loggedCore(RR, 2, &log);
+    submitJob(core, 1, 0, 4);
+    schedAdvance(core, 2);
+    submitJob(core, 2, 0, 2);
+    runToEnd(core);
+    CHECK(log.order[0] == 1 && log.order[log.dispatches - 1] == 2);
+    CHECK(core->table->records[0].finish_time == 4);
+    schedDestroy(core);
+}
+
+// Function to replay jobs on one core, submitting each at its arrival before
+// the timers due at the same instant, and describe the run like sim.c does
+void replayDirect(const Process* jobs, int count, int alg, int quantum, SimResult* result) {
+    SchedCore* core = schedCreate(alg, quantum);
+    schedStartClock(core, jobs[0].arrival_time);
+    for (int i = 0; i < count; i++) {
+        SchedDispatch dispatch;
+        schedNextDispatch(core, &dispatch);
+        while (dispatch.next_event != -1 && dispatch.next_event < jobs[i].arrival_time) {
+            schedAdvance(core, dispatch.next_event);
+            schedNextDispatch(core, &dispatch);
+        }
+        SchedJob job = cpuJob(jobs[i].id, jobs[i].priority, jobs[i].runtime);
+        job.burst_count = jobs[i].burst_count;
+        memcpy(job.bursts, jobs[i].bursts, sizeof(job.bursts));
+        schedSetTime(core, jobs[i].arrival_time);
+        schedSubmit(core, &job);
+    }
+    runToEnd(core);
+
+    SchedCoreStats stats;
+    schedGetStats(core, &stats);
+    memset(result, 0, sizeof(SimResult));
+    result->makespan = core->now;
+    result->busy_time = core->total_runtime - core->idle_time;
+    result->dispatches = core->dispatches;
+    result->preemptions = core->preemptions;
+    result->avg_wta = stats.avg_wta;
+    result->avg_waiting = stats.avg_waiting;
+    schedDestroy(core);
+}
+
+// A replay cut into segments on several threads gives exactly what one core
+// gives for the whole trace, under every policy and with I/O bursts
+void testParallelReplayMatchesCore() {
+    int count = 20000;
+    Process* jobs = (Process*)calloc(count, sizeof(Process));
+    unsigned int seed = 1;
+    int arrival = 0;
+    for (int i = 0; i < count; i++) {
+        jobs[i].id = i + 1;
+        jobs[i].arrival_time = arrival;
+        jobs[i].priority = rand_r(&seed) % 11;
+        jobs[i].runtime = 1 + rand_r(&seed) % 8;
+        jobs[i].table_index = -1;
+        if (i % 5 == 0) {
+            jobs[i].burst_count = 3;
+            jobs[i].bursts[0] = 1 + rand_r(&seed) % 3;
+            jobs[i].bursts[1] = 1 + rand_r(&seed) % 4;
+            jobs[i].bursts[2] = jobs[i].runtime - jobs[i].bursts[0] > 0 ? jobs[i].runtime - jobs[i].bursts[0] : 1;
+            jobs[i].runtime = jobs[i].bursts[0] + jobs[i].bursts[2];
+        } else {
+            jobs[i].burst_count = 1;
+            jobs[i].bursts[0] = jobs[i].runtime;
+        }
+        arrival += rand_r(&seed) % 12;
+    }
+
+    for (int alg = HPF; alg <= ALGORITHM_COUNT; alg++) {
+        for (int quantum = ADAPTIVE_QUANTUM; quantum <= 2; quantum += 2) {
+            SimResult reference, sim;
+            replayDirect(jobs, count, alg, quantum, &reference);
+            CHECK(simulateTraceParallel(jobs, count, alg, quantum, 4, &sim) == 0);
+            bool same = sim.makespan == reference.makespan && sim.busy_time == reference.busy_time &&
+                        sim.dispatches == reference.dispatches &&
+                        sim.preemptions == reference.preemptions && sim.avg_wta == reference.avg_wta &&
+                        sim.avg_waiting == reference.avg_waiting;
+            if (!same) printf("  algorithm %d, quantum %d differs\n", alg, quantum);
+            CHECK(same);
+            if (alg == HPF) CHECK(sim.segments > 1);
+            if (alg == LOTTERY) CHECK(sim.segments == 1);
+        }
+    }
+    SimResult sim;
+    CHECK(simulateTraceParallel(jobs, count, ALGORITHM_COUNT + 1, 2, 4, &sim) == -1);
+    free(jobs);
+}
+
+// Dependencies are kept by job id, so ids far apart cost no more than ids in
+// a row and a negative id is turned away; a trace without dependencies builds
+// no nodes at all
+void testDependenciesKeyedById() {
+    SchedCore* core = schedCreate(HPF, 0);
+    CHECK(submitJob(core, -3, 0, 1) == -1);
+
+    int first = submitJob(core, 1, 0, 2);
+    schedAdvance(core, 2);
+    CHECK(core->table->records[first].state == FINISHED);
+    CHECK(core->dep_capacity == 0);
+
+    // The parent finished before any job had parents
+    SchedJob job = cpuJob(2000000000, 0, 1);
+    job.dep_count = 1;
+    job.deps[0] = 1;
+    int far = schedSubmit(core, &job);
+    CHECK(core->table->records[far].state != PENDING);
+
+    job = cpuJob(5, 0, 1);
+    job.dep_count = 1;
+    job.deps[0] = 2000000000;
+    int child = schedSubmit(core, &job);
+    CHECK(core->table->records[child].state == PENDING);
+
+    // A parent that never arrives holds its child until the orphans go
+    job = cpuJob(7, 0, 1);
+    job.dep_count = 1;
+    job.deps[0] = 1500000000;
+    int orphan = schedSubmit(core, &job);
+    runToEnd(core);
+    CHECK(core->table->records[child].state == FINISHED);
+    CHECK(core->table->records[child].start_time >= core->table->records[far].finish_time);
+    CHECK(core->table->records[orphan].state == PENDING);
+
+    schedReleaseOrphans(core);
+    runToEnd(core);
+    CHECK(core->table->records[orphan].state == FINISHED);
+    CHECK(core->dep_capacity <= 64);
+    schedDestroy(core);
+}
+
+// Function to create the scratch directory of an end-to-end test, with links
+// to the binaries and trace as its processes.txt. Output from an earlier
+// run of the test is removed first.
+int prepareRun(const char* name, const char* trace, char* dir, size_t size) {
+    char cwd[PATH_MAX];
+    if (getcwd(cwd, sizeof(cwd)) == NULL) return -1;
+    if (mkdir(RUN_BASE, 0755) == -1 && errno != EEXIST) return -1;
+    snprintf(dir, size, "%s/%s/%s", cwd, RUN_BASE, name);
+    if (mkdir(dir, 0755) == -1 && errno != EEXIST) return -1;
+
+    const char* binaries[] = { "clk", "process", "scheduler", "process_generator" };
+    const char* outputs[] = { "scheduler.log", "scheduler.perf", "scheduler.trace", CHECKPOINT_FILE, "run.out" };
+    char path[PATH_MAX * 2];
+    char target[PATH_MAX * 2];
+    for (int i = 0; i < 4; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, binaries[i]);
+        snprintf(target, sizeof(target), "%s/%s", cwd, binaries[i]);
+        unlink(path);
+        if (symlink(target, path) == -1) return -1;
+    }
+    for (int i = 0; i < 5; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, outputs[i]);
+        unlink(path);
+    }
+
+    snprintf(path, sizeof(path), "%s/processes.txt", dir);
+    FILE* file = fopen(path, "w");
+    if (!file) return -1;
+    fputs(trace, file);
+    fclose(file);
+    return 0;
+}
+
+// Function to start process_generator in dir with the given arguments (NULL
+// terminated), its output going to run.out. Returns its pid.
+int startGenerator(const char* dir, char* const args[]) {
+    int pid = fork();
+    if (pid == 0) {
+        if (chdir(dir) == -1) exit(1);
+        int out = open("run.out", O_CREAT | O_WRONLY | O_APPEND, 0644);
+        int in = open("/dev/null", O_RDONLY);
+        dup2(in, STDIN_FILENO);
+        dup2(out, STDOUT_FILENO);
+        dup2(out, STDERR_FILENO);
+        execv("./process_generator", args);
+        exit(127);
+    }
+    return pid;
+}
+
+// Function to wait for a generator started by startGenerator(), interrupting
+// it after timeout seconds. Returns its exit status, -1 if it had to be
+// interrupted.
+int waitGenerator(int pid, int timeout) {
+    time_t deadline = time(NULL) + timeout;
+    int status;
+    while (waitpid(pid, &status, WNOHANG) == 0) {
+        if (time(NULL) > deadline) {
+            // SIGINT lets process_generator clear its IPC resources
+            kill(pid, SIGINT);
+            waitpid(pid, &status, 0);
+            return -1;
+        }
+        usleep(100000);
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// Function to count the lines of a file in dir that contain text
+int countLines(const char* dir, const char* name, const char* text) {
+    char path[PATH_MAX * 2];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* file = fopen(path, "r");
+    if (!file) return 0;
+
+    char line[512];
+    int count = 0;
+    while (fgets(line, sizeof(line), file)) {
+        if (strstr(line, text) != NULL) count++;
+    }
+    fclose(file);
+    return count;
+}
+
+// The scheduler runs until the generator says no more jobs will come, not
+// until the jobs it has seen so far are done: job 1 finishes long before
+// job 2 arrives
+void testRunWaitsForGenerator() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "1\t0\t1\t0\n"
+                        "2\t3\t1\t0\n";
+    CHECK(prepareRun("wait_for_generator", trace, dir, sizeof(dir)) == 0);
+
+    char* args[] = { "process_generator", "-a", "1", "-f", "processes.txt", NULL };
+    CHECK(waitGenerator(startGenerator(dir, args), 20) == 0);
+    CHECK(countLines(dir, "scheduler.log", "process 1 finished") == 1);
+    CHECK(countLines(dir, "scheduler.log", "process 2 finished") == 1);
+    CHECK(countLines(dir, "scheduler.perf", "Avg WTA") == 1);
+}
+
+// Function to write text to a file in dir
+int writeFile(const char* dir, const char* name, const char* text) {
+    char path[PATH_MAX * 3];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* file = fopen(path, "w");
+    if (!file) return -1;
+    fputs(text, file);
+    fclose(file);
+    return 0;
+}
+
+// Job ids may be sparse: the generator finds a parent by its id without an
+// array as large as the largest one, and still turns a negative id away.
+// Job 1 leads to the far job, so its critical path outranks job 4 under CP.
+void testSparseIdsRun() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "1\t0\t2\t0\n"
+                        "2000000000\t0\t3\t0\tdeps=1\n"
+                        "3\t0\t1\t0\n"
+                        "4\t0\t4\t0\n";
+    CHECK(prepareRun("sparse_ids_run", trace, dir, sizeof(dir)) == 0);
+
+    char* args[] = { "process_generator", "-a", "10", "-f", "processes.txt", NULL };
+    CHECK(waitGenerator(startGenerator(dir, args), 30) == 0);
+    CHECK(countLines(dir, "scheduler.log", "At time 2 process 1 finished") == 1);
+    CHECK(countLines(dir, "scheduler.log", "At time 9 process 2000000000 finished") == 1);
+
+    CHECK(writeFile(dir, "processes.txt", "-3\t0\t1\t0\n") == 0);
+    CHECK(waitGenerator(startGenerator(dir, args), 30) > 0);
+}
+
+// A sweep run that is interrupted must not be reported with the metrics a
+// previous sweep left in its directory
+void testSweepIgnoresStalePerf() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "1\t0\t30\t0\n";
+    CHECK(prepareRun("sweep_stale_perf", trace, dir, sizeof(dir)) == 0);
+
+    char runs[PATH_MAX * 2];
+    snprintf(runs, sizeof(runs), "%s/runs", dir);
+    mkdir(runs, 0755);
+    snprintf(runs, sizeof(runs), "%s/runs/run000", dir);
+    mkdir(runs, 0755);
+    CHECK(writeFile(runs, "scheduler.perf", "CPU utilization = 100.00%\nAvg WTA = 1.00\n"
+                    "Avg Waiting = 0.00\nStd WTA = 0.00\n") == 0);
+
+    int pid = fork();
+    if (pid == 0) {
+        int out = open("/dev/null", O_WRONLY);
+        dup2(out, STDOUT_FILENO);
+        snprintf(runs, sizeof(runs), "%s/runs", dir);
+        char table[PATH_MAX * 2];
+        snprintf(table, sizeof(table), "%s/sweep.txt", dir);
+        char trace_path[PATH_MAX * 2];
+        snprintf(trace_path, sizeof(trace_path), "%s/processes.txt", dir);
+        execl("./sweep", "sweep", "-a", "1", "-T", "1", "-d", runs, "-o", table, trace_path, NULL);
+        exit(127);
+    }
+    CHECK(waitGenerator(pid, 30) == 0);
+    CHECK(countLines(dir, "sweep.txt", "timed out") == 1);
+    CHECK(countLines(dir, "sweep.txt", " ok") == 0);
+}
+
+// Function to get the column text starts at on the first line of a file in
+// dir that contains it, or -1
+int columnOf(const char* dir, const char* name, const char* text) {
+    char path[PATH_MAX * 2];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* file = fopen(path, "r");
+    if (!file) return -1;
+
+    char line[512];
+    int column = -1;
+    while (column == -1 && fgets(line, sizeof(line), file)) {
+        char* found = strstr(line, text);
+        if (found != NULL) column = found - line;
+    }
+    fclose(file);
+    return column;
+}
+
+// The sweep table keeps its columns lined up for the longest algorithm names
+void testSweepAlignsColumns() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "1\t0\t1\t0\n";
+    CHECK(prepareRun("sweep_aligns_columns", trace, dir, sizeof(dir)) == 0);
+
+    char sweep[PATH_MAX];
+    CHECK(realpath("sweep", sweep) != NULL);
+    int pid = fork();
+    if (pid == 0) {
+        if (chdir(dir) == -1) exit(127);
+        int out = open("/dev/null", O_WRONLY);
+        dup2(out, STDOUT_FILENO);
+        execl(sweep, "sweep", "-a", "1,8", "-q", "2", "-d", "runs", "-o", "sweep.txt", "processes.txt", NULL);
+        exit(127);
+    }
+    CHECK(waitGenerator(pid, 60) == 0);
+    int quantum = columnOf(dir, "sweep.txt", "quantum");
+    CHECK(quantum > 0);
+    CHECK(columnOf(dir, "sweep.txt", "      - ") == quantum);
+    CHECK(columnOf(dir, "sweep.txt", "      2 ") == quantum);
+    CHECK(countLines(dir, "sweep.txt", " ok") == 2);
+}
+
+// A timed-out run whose generator ignores SIGINT is killed after a grace
+// period instead of being sent SIGINT again forever. The generator here is a
+// script that ignores SIGINT and sleeps.
+void testSweepKillsHungRun() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "1\t0\t1\t0\n";
+    CHECK(prepareRun("sweep_kills_hung_run", trace, dir, sizeof(dir)) == 0);
+    CHECK(writeFile(dir, "hung_generator", "#!/bin/sh\ntrap '' INT\nexec sleep 60\n") == 0);
+
+    // Sweep links the generator of the directory it runs in
+    char path[PATH_MAX * 2];
+    snprintf(path, sizeof(path), "%s/hung_generator", dir);
+    chmod(path, 0755);
+    snprintf(path, sizeof(path), "%s/process_generator", dir);
+    unlink(path);
+    CHECK(symlink("hung_generator", path) == 0);
+
+    char sweep[PATH_MAX];
+    CHECK(realpath("sweep", sweep) != NULL);
+    time_t start = time(NULL);
+    int pid = fork();
+    if (pid == 0) {
+        if (chdir(dir) == -1) exit(127);
+        int out = open("/dev/null", O_WRONLY);
+        dup2(out, STDOUT_FILENO);
+        execl(sweep, "sweep", "-a", "1", "-T", "1", "-d", "runs", "-o", "sweep.txt", "processes.txt", NULL);
+        exit(127);
+    }
+    CHECK(waitGenerator(pid, 30) == 0);
+    CHECK(time(NULL) - start < 20);
+    CHECK(countLines(dir, "sweep.txt", "killed") == 1);
+}
+
+// Job id 0 is a valid job, so it is a valid parent too
+void testDependsOnJobZero() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "0\t0\t2\t5\n"
+                        "1\t0\t1\t0\tdeps=0\n";
+    CHECK(prepareRun("depends_on_job_zero", trace, dir, sizeof(dir)) == 0);
+
+    char* args[] = { "process_generator", "-a", "1", "-f", "processes.txt", NULL };
+    CHECK(waitGenerator(startGenerator(dir, args), 30) == 0);
+    CHECK(countLines(dir, "scheduler.log", "At time 2 process 0 finished") == 1);
+    CHECK(countLines(dir, "scheduler.log", "At time 3 process 1 finished") == 1);
+}
+
+// Function to wait until the run in dir has checkpointed at time or later,
+// giving up after timeout seconds
+int waitCheckpoint(const char* dir, int time, int timeout) {
+    char path[PATH_MAX * 2];
+    snprintf(path, sizeof(path), "%s/%s", dir, CHECKPOINT_FILE);
+    for (int waited = 0; waited < timeout * 10; waited++) {
+        CheckpointHeader header;
+        if (access(path, R_OK) == 0 && readCheckpointHeader(path, &header) == 0 && header.time >= time) {
+            return 0;
+        }
+        usleep(100000);
+    }
+    return -1;
+}
+
+// Function to count the events of a type for a process in the trace in dir.
+// Returns -1 if the trace does not hold exactly one header.
+int countTraceEvents(const char* dir, int type, int process_id) {
+    char path[PATH_MAX * 2];
+    snprintf(path, sizeof(path), "%s/%s", dir, TRACE_FILE);
+    FILE* file = fopen(path, "rb");
+    if (!file) return -1;
+
+    TraceHeader header;
+    TraceEvent event;
+    int count = 0;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != TRACE_MAGIC) count = -1;
+    while (count != -1 && fread(&event, sizeof(event), 1, file) == 1) {
+        // A second header reads as an event stamped with the magic number
+        if (event.time == TRACE_MAGIC) count = -1;
+        else if (event.type == type && event.process_id == process_id) count++;
+    }
+    fclose(file);
+    return count;
+}
+
+// A run resumed from a checkpoint continues the trace of the original run,
+// as it does the log, instead of starting it over: job 1 finished before
+// the checkpoint and must still be in both. The arrival figures count it too,
+// and the generator's, which do not, say so.
+void testRestoreKeepsTrace() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "1\t0\t2\t0\n"
+                        "2\t8\t1\t0\n";
+    CHECK(prepareRun("restore_keeps_trace", trace, dir, sizeof(dir)) == 0);
+
+    char* first[] = { "process_generator", "-a", "1", "-c", "2", "-f", "processes.txt", NULL };
+    int pid = startGenerator(dir, first);
+    CHECK(waitCheckpoint(dir, 4, 20) == 0);
+    kill(pid, SIGINT);
+    waitpid(pid, NULL, 0);
+    CHECK(countTraceEvents(dir, EVENT_FINISH, 1) == 1);
+
+    char* resumed[] = { "process_generator", "-r", CHECKPOINT_FILE, "-f", "processes.txt", NULL };
+    CHECK(waitGenerator(startGenerator(dir, resumed), 30) == 0);
+    CHECK(countTraceEvents(dir, EVENT_FINISH, 1) == 1);
+    CHECK(countTraceEvents(dir, EVENT_FINISH, 2) == 1);
+    CHECK(countLines(dir, "scheduler.log", "process 1 finished") == 1);
+    CHECK(countLines(dir, "scheduler.log", "process 2 finished") == 1);
+    CHECK(countLines(dir, "scheduler.perf", "Late arrivals = 0 of 2") == 1);
+    CHECK(countLines(dir, "scheduler.perf", "Generator figures since the resume at time") == 1);
+}
+
+// A resumed generator skips every job the scheduler had seen go by before the
+// checkpoint, dropped ones included, not as many jobs as it had received:
+// with a window of one, jobs 2 and 3 are dropped, and job 4 must not be sent
+// again after the restore
+void testRestoreSkipsDroppedJobs() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "1\t0\t1\t0\n"
+                        "2\t0\t1\t0\n"
+                        "3\t0\t1\t0\n"
+                        "4\t5\t1\t0\n"
+                        "5\t11\t1\t0\n";
+    CHECK(prepareRun("restore_skips_dropped", trace, dir, sizeof(dir)) == 0);
+
+    char* first[] = { "process_generator", "-a", "1", "-c", "2", "-w", "1", "-o", "drop",
+                      "-f", "processes.txt", NULL };
+    int pid = startGenerator(dir, first);
+    CHECK(waitCheckpoint(dir, 8, 20) == 0);
+    kill(pid, SIGINT);
+    waitpid(pid, NULL, 0);
+    CHECK(countLines(dir, "scheduler.log", "process 4 finished") == 1);
+
+    char* resumed[] = { "process_generator", "-r", CHECKPOINT_FILE, "-f", "processes.txt", NULL };
+    CHECK(waitGenerator(startGenerator(dir, resumed), 30) == 0);
+    CHECK(countLines(dir, "run.out", "Process 4 sent") == 1);
+    CHECK(countLines(dir, "scheduler.log", "process 4 finished") == 1);
+    CHECK(countLines(dir, "scheduler.log", "process 5 finished") == 1);
+    for (int id = 2; id <= 3; id++) {
+        char finished[32], dropped[32];
+        snprintf(finished, sizeof(finished), "process %d finished", id);
+        snprintf(dropped, sizeof(dropped), "Process %d dropped", id);
+        CHECK(countLines(dir, "scheduler.log", finished) + countLines(dir, "run.out", dropped) == 1);
+    }
+}
+
+// A resumed fair-share run keeps the passes its groups had reached. Group a
+// used 6 ticks alone before the checkpoint; jobs of groups a and b then arrive
+// while a job of group c runs, so both are ready when the groups are next
+// compared and b's job goes first. With the passes lost every group would
+// restart at 0 and a, created first, would win the tie.
+void testRestoreKeepsGroupPasses() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "1\t0\t6\t0\tgroup=a\n"
+                        "4\t9\t2\t0\tgroup=c\n"
+                        "2\t10\t2\t0\tgroup=b\n"
+                        "3\t10\t2\t0\tgroup=a\n";
+    CHECK(prepareRun("restore_keeps_group_passes", trace, dir, sizeof(dir)) == 0);
+
+    char* first[] = { "process_generator", "-a", "7", "-q", "2", "-c", "2", "-f", "processes.txt", NULL };
+    int pid = startGenerator(dir, first);
+    CHECK(waitCheckpoint(dir, 8, 20) == 0);
+    kill(pid, SIGINT);
+    waitpid(pid, NULL, 0);
+    CHECK(countLines(dir, "scheduler.log", "At time 6 process 1 finished") == 1);
+
+    char* resumed[] = { "process_generator", "-r", CHECKPOINT_FILE, "-f", "processes.txt", NULL };
+    CHECK(waitGenerator(startGenerator(dir, resumed), 30) == 0);
+    CHECK(countLines(dir, "scheduler.log", "At time 11 process 4 finished") == 1);
+    CHECK(countLines(dir, "scheduler.log", "At time 13 process 2 finished") == 1);
+    CHECK(countLines(dir, "scheduler.log", "At time 15 process 3 finished") == 1);
+}
+
+// A resumed PSRTN run keeps the burst predictions it had learned. Before the
+// checkpoint priority 0 ran a burst of 6 and priority 5 one of 1, so when one
+// job of each arrives afterwards the priority 5 job is predicted shorter and
+// takes the CPU. With the predictions lost both would be predicted 1 and the
+// job that arrived first would keep running.
+void testRestoreKeepsPredictions() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "1\t0\t6\t0\n"
+                        "4\t6\t1\t5\n"
+                        "2\t10\t2\t0\n"
+                        "3\t10\t2\t5\n";
+    CHECK(prepareRun("restore_keeps_predictions", trace, dir, sizeof(dir)) == 0);
+
+    char* first[] = { "process_generator", "-a", "6", "-c", "2", "-f", "processes.txt", NULL };
+    int pid = startGenerator(dir, first);
+    CHECK(waitCheckpoint(dir, 8, 20) == 0);
+    kill(pid, SIGINT);
+    waitpid(pid, NULL, 0);
+    CHECK(countLines(dir, "scheduler.log", "At time 7 process 4 finished") == 1);
+
+    char* resumed[] = { "process_generator", "-r", CHECKPOINT_FILE, "-f", "processes.txt", NULL };
+    CHECK(waitGenerator(startGenerator(dir, resumed), 30) == 0);
+    CHECK(countLines(dir, "scheduler.log", "At time 12 process 3 finished") == 1);
+    CHECK(countLines(dir, "scheduler.log", "At time 14 process 2 finished") == 1);
+    CHECK(countLines(dir, "scheduler.perf", "Predicted bursts = 4") == 1);
+}
+
+// A resumed run with the adaptive quantum keeps the bursts it had seen and
+// the slices it had handed out. Job 1 completed a burst of 6 before the
+// checkpoint, so afterwards the quantum is 6 and job 2 runs its 4 ticks in one
+// slice. With the window lost the quantum would start again at 1 and the two
+// jobs would take turns.
+void testRestoreKeepsQuantumWindow() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "1\t0\t6\t0\n"
+                        "2\t10\t4\t0\n"
+                        "3\t10\t4\t0\n";
+    CHECK(prepareRun("restore_keeps_quantum_window", trace, dir, sizeof(dir)) == 0);
+
+    char* first[] = { "process_generator", "-a", "3", "-q", "0", "-c", "2", "-f", "processes.txt", NULL };
+    int pid = startGenerator(dir, first);
+    CHECK(waitCheckpoint(dir, 8, 20) == 0);
+    kill(pid, SIGINT);
+    waitpid(pid, NULL, 0);
+    CHECK(countLines(dir, "scheduler.log", "At time 6 process 1 finished") == 1);
+
+    char* resumed[] = { "process_generator", "-r", CHECKPOINT_FILE, "-f", "processes.txt", NULL };
+    CHECK(waitGenerator(startGenerator(dir, resumed), 30) == 0);
+    CHECK(countLines(dir, "scheduler.log", "At time 14 process 2 finished") == 1);
+    CHECK(countLines(dir, "scheduler.log", "At time 18 process 3 finished") == 1);
+    CHECK(countLines(dir, "scheduler.perf", "Min slice = 1") == 1);
+    CHECK(countLines(dir, "scheduler.perf", "Max slice = 4") == 1);
+}
+
+// A snapshot only resumes with the quantum it was taken with; a different
+// one, or the adaptive quantum instead of a fixed one, would change the run
+void testRestoreRejectsOtherQuantum() {
+    char dir[PATH_MAX];
+    const char* trace = "#id\tarrival\truntime\tpriority\n"
+                        "1\t0\t6\t0\n"
+                        "2\t10\t2\t0\n";
+    CHECK(prepareRun("restore_rejects_other_quantum", trace, dir, sizeof(dir)) == 0);
+
+    char* first[] = { "process_generator", "-a", "3", "-q", "2", "-c", "2", "-f", "processes.txt", NULL };
+    int pid = startGenerator(dir, first);
+    CHECK(waitCheckpoint(dir, 4, 20) == 0);
+    kill(pid, SIGINT);
+    waitpid(pid, NULL, 0);
+
+    char* other[] = { "process_generator", "-r", CHECKPOINT_FILE, "-q", "3", "-f", "processes.txt", NULL };
+    CHECK(waitGenerator(startGenerator(dir, other), 30) > 0);
+    char* adaptive[] = { "process_generator", "-r", CHECKPOINT_FILE, "-q", "0", "-f", "processes.txt", NULL };
+    CHECK(waitGenerator(startGenerator(dir, adaptive), 30) > 0);
+    CHECK(countLines(dir, "run.out", "checkpoint was taken with quantum 2") == 2);
+
+    char* same[] = { "process_generator", "-r", CHECKPOINT_FILE, "-q", "2", "-f", "processes.txt", NULL };
+    CHECK(waitGenerator(startGenerator(dir, same), 30) == 0);
+    CHECK(countLines(dir, "scheduler.log", "process 2 finished") == 1);
+}
+
+SchedTest tests[] = {
+    { "running_survives_table_growth", testRunningSurvivesTableGrowth, false },
+    { "duplicate_termination_ignored", testDuplicateTerminationIgnored, false },
+    { "queues_grow", testQueuesGrow, false },
+    { "one_advance_matches_stepping", testOneAdvanceMatchesStepping, false },
+    { "srtn_preemption_dispatches_one", testSrtnPreemptionDispatchesOne, false },
+    { "srtn_compares_running_slice", testSrtnComparesRunningSlice, false },
+    { "rr_arrival_before_quantum_end", testRrArrivalBeforeQuantumEnd, false },
+    { "parallel_replay_matches_core", testParallelReplayMatchesCore, false },
+    { "dependencies_keyed_by_id", testDependenciesKeyedById, false },
+    { "run_waits_for_generator", testRunWaitsForGenerator, true },
+    { "sweep_ignores_stale_perf", testSweepIgnoresStalePerf, true },
+    { "sweep_kills_hung_run", testSweepKillsHungRun, true },
+    { "sweep_aligns_columns", testSweepAlignsColumns, true },
+    { "restore_keeps_trace", testRestoreKeepsTrace, true },
+    { "restore_skips_dropped_jobs", testRestoreSkipsDroppedJobs, true },
+    { "restore_keeps_group_passes", testRestoreKeepsGroupPasses, true },
+    { "sparse_ids_run", testSparseIdsRun, true },
+    { "depends_on_job_zero", testDependsOnJobZero, true },
+    { "restore_keeps_predictions", testRestoreKeepsPredictions, true },
+    { "restore_keeps_quantum_window", testRestoreKeepsQuantumWindow, true },
+    { "restore_rejects_other_quantum", testRestoreRejectsOtherQuantum, true },
+};
+
+int main(int argc, char *argv[]) {
+    bool core_only = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c")) != -1) {
+        if (opt == 'c') {
+            core_only = true;
+        } else {
+            printf("Usage: %s [-c]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    int failed = 0;
+    int count = 0;
+    for (int i = 0; i < (int)(sizeof(tests) / sizeof(tests[0])); i++) {
+        if (core_only && tests[i].end_to_end) continue;
+        count++;
+
+        int before = checks_failed;
+        tests[i].run();
+        bool ok = checks_failed == before;
+        if (!ok) failed++;
+        printf("%-40s %s\n", tests[i].name, ok ? "ok" : "FAILED");
+        fflush(stdout);
+    }
+
+    printf("%d of %d tests passed\n", count - failed, count);
+    return failed;
+}
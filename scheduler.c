@@ -1,4 +1,12 @@
+#define _GNU_SOURCE // sched_setaffinity()
 #include "headers.h"
+#include <sched.h>
+#include <sys/resource.h>
+
+// The scheduler process: it drives a scheduling core (see schedcore.c) from
+// the clock process and the generator's messages, and carries out the core's
+// decisions on real processes, forking ./process or a real job's command line
+// for every dispatch and stopping and resuming them with signals.
 
 int msgq_id;
 int shm_id;
@@ -8,429 +16,810 @@ int quantum;
 FILE *log_file;
 FILE *perf_file;
 
-// Data structures for different scheduling algorithms
-PriorityQueue* hpf_queue = NULL;    // For HPF algorithm
-PriorityQueue* srtn_queue = NULL;   // For SRTN algorithm
-CircularQueue* rr_queue = NULL;     // For RR algorithm
+// The scheduling core; it holds the process table and every queue
+SchedCore* core = NULL;
+
+// Live statistics page
+int stats_shm_id = -1;
+SchedStats *stats_page = NULL;
+long last_second_dispatches = 0;
+int dispatch_rate = 0;
+
+// Control-plane latency per phase; queue operations are timed by the core
+LatencyHistogram ipc_latency;
+LatencyHistogram dispatch_latency;
+LatencyHistogram log_latency;
+
+// How late arrivals were delivered compared with their arrival_time, and the
+// generator's flow-control counters from its GENERATOR_DONE message
+int arrivals_received = 0;
+int trace_position = 0;       // Jobs of the generator's arrival order sent or dropped so far
+int late_arrivals = 0;
+long total_lateness = 0;
+int max_lateness = 0;
+long lateness_buckets[LATENESS_BUCKETS];
+FlowCounters generator_flow;
+bool flow_reported = false;
+int resumed_at = -1;          // Clock value the run resumed from a snapshot at, -1 if it did not
 
-// Process table for tracking all processes
-Process* process_table = NULL;
-int process_count = 0;
-Process* running_process = NULL;
+// Periodic snapshots (see takeCheckpoint)
+int checkpoint_every = 0;     // Interval in clock ticks, 0 disables snapshots
+int last_checkpoint_time = 0;
+int checkpoint_pid = 0;       // Writer still running, 0 if none
 
-// Statistics
-int total_runtime = 0;
-int idle_time = 0;
-int last_clock = 0;
-double *turnaround_times = NULL;
-double *weighted_turnaround_times = NULL;
-int finished_count = 0;
+// Real jobs, indexed like the process table
+char** commands = NULL;       // Command line, NULL for simulated processes
+RealUsage* real_usage = NULL; // Measured when the job exits
+int real_cpu = -1;            // CPU real jobs are pinned to, -1 for none
+
+// The core keeps its own timers for quanta and I/O; these are the scheduler's
+TimerWheel* timers = NULL;
+Timer stats_timer;            // Once-per-tick state log and statistics page
+Timer checkpoint_timer;       // Next periodic snapshot
 
 // Function to initialize scheduler
 void initScheduler(int alg) {
     algorithm = alg;
-    
-    // Open log file
-    log_file = fopen("scheduler.log", "w");
+    const char* restore_path = getenv(ENV_RESTORE);
+    if (getenv(ENV_CHECKPOINT_EVERY) != NULL) {
+        checkpoint_every = atoi(getenv(ENV_CHECKPOINT_EVERY));
+    }
+    if (getenv(ENV_REAL_CPU) != NULL) {
+        real_cpu = atoi(getenv(ENV_REAL_CPU));
+    }
+
+    // Processes report the end of their bursts themselves
+    core = schedCreate(alg, quantum);
+    if (core == NULL) {
+        printf("Error: this scheduler does not implement algorithm %d\n", alg);
+        exit(1);
+    }
+    core->external_bursts = true;
+    schedSetCallback(core, handleCoreEvent, NULL);
+    if (getenv(ENV_QUANTUM_PERCENTILE) != NULL) {
+        core->quantum_percentile = atoi(getenv(ENV_QUANTUM_PERCENTILE));
+    }
+
+    // Open log file; a resumed run continues the log of the original one
+    log_file = fopen("scheduler.log", restore_path != NULL ? "a" : "w");
     if (!log_file) {
         perror("Error opening log file");
         exit(1);
     }
-    
+
     // Write header to log file
-    fprintf(log_file, "#At time x process y state arr w total z remain y wait k\n");
-    
+    if (restore_path == NULL) {
+        fprintf(log_file, "#At time x process y state arr w total z remain y wait k\n");
+    }
+
+    // The binary event stream is optional; the run continues without it
+    openTrace(TRACE_FILE, alg, quantum, restore_path != NULL);
+
     // Attach to shared memory and message queue
-    key_t key_shm = ftok("keyfile", 'C');
-    shm_id = shmget(key_shm, sizeof(SharedClock), 0666);
+    shm_id = getIpcId(ENV_CLOCK_SHM);
     shm_clock = (SharedClock *)shmat(shm_id, NULL, 0);
-    
-    key_t key_msg = ftok("keyfile", 'M');
-    msgq_id = msgget(key_msg, 0666);
-    
-    last_clock = shm_clock->current_time;
-    
-    // Initialize appropriate data structure based on algorithm
-    if (algorithm == HPF) {
-        hpf_queue = createPriorityQueue(100);  // Assuming max 100 processes
-    } else if (algorithm == SRTN) {
-        srtn_queue = createPriorityQueue(100);
-    } else if (algorithm == RR) {
-        rr_queue = createCircularQueue(100);
+
+    msgq_id = getIpcId(ENV_MSGQ);
+
+    schedStartClock(core, shm_clock->current_time);
+
+    timers = createTimerWheel(shm_clock->current_time);
+    initTimer(&stats_timer, TIMER_STATS, -1);
+    initTimer(&checkpoint_timer, TIMER_CHECKPOINT, -1);
+
+    if (restore_path != NULL) {
+        restoreCheckpoint(restore_path);
+    }
+
+    addTimer(timers, &stats_timer, shm_clock->current_time);
+    if (checkpoint_every > 0) {
+        addTimer(timers, &checkpoint_timer, last_checkpoint_time + checkpoint_every);
     }
+
+    attachStatsShm();
+}
+
+// Function to get the running process, or NULL while the CPU is idle
+Process* runningProcess() {
+    return core->running_index != -1 ? &core->table->records[core->running_index] : NULL;
 }
 
 // Function to handle process arrival
-void processArrival(Process process) {
-    // Add process to process table
-    process_count++;
-    process_table = realloc(process_table, process_count * sizeof(Process));
-    process_table[process_count - 1] = process;
-    
-    // Allocate memory for statistics arrays
-    turnaround_times = realloc(turnaround_times, process_count * sizeof(double));
-    weighted_turnaround_times = realloc(weighted_turnaround_times, process_count * sizeof(double));
-    
-    printf("Process %d arrived at time %d\n", process.id, shm_clock->current_time);
-    
-    // Add process to appropriate queue based on algorithm
-    if (algorithm == HPF) {
-        insertPriorityPriorityQueue(hpf_queue, process);
-    } else if (algorithm == SRTN) {
-        insertRuntimePriorityQueue(srtn_queue, process);
-    } else if (algorithm == RR) {
-        enqueueCircularQueue(rr_queue, process);
-    }
-    
+void processArrival(Process process, const char* command) {
+    admitProcess(process, command);
+
     // Schedule process based on algorithm
-    scheduleProcess();
+    schedSchedule(core);
 }
 
-// Function to find process in process table by ID
-Process* findProcessById(int id) {
-    for (int i = 0; i < process_count; i++) {
-        if (process_table[i].id == id) {
-            return &process_table[i];
-        }
+// Function to add an arrived process to the core without scheduling. command
+// is the command line of a real job, or empty for a simulated one; a real job
+// runs until it exits, whatever its trace runtime says.
+void admitProcess(Process process, const char* command) {
+    schedSetTime(core, shm_clock->current_time);
+    recordLateness(&process);
+    int index = schedAdmit(core, process, command[0] != '\0');
+
+    commands = realloc(commands, core->table->count * sizeof(char*));
+    real_usage = realloc(real_usage, core->table->count * sizeof(RealUsage));
+    commands[index] = command[0] != '\0' ? strdup(command) : NULL;
+    memset(&real_usage[index], 0, sizeof(RealUsage));
+}
+
+// Function to count how many ticks after its arrival_time a job reached the
+// scheduler; the delay also shows up in its waiting time
+void recordLateness(const Process* process) {
+    int lateness = shm_clock->current_time - process->arrival_time;
+    if (lateness < 0) lateness = 0;
+
+    arrivals_received++;
+    if (lateness > 0) {
+        late_arrivals++;
+        total_lateness += lateness;
+        if (lateness > max_lateness) max_lateness = lateness;
+    }
+
+    // Buckets 0, 1, 2-3, 4-7 and 8+
+    int bucket = 0;
+    while (bucket < LATENESS_BUCKETS - 1 && lateness >= (1 << bucket)) {
+        bucket++;
+    }
+    lateness_buckets[bucket]++;
+}
+
+// Function to return window credits for the arrival messages just consumed
+void returnCredits(int credits) {
+    AckMessage ack;
+    ack.mtype = ARRIVAL_ACK;
+    ack.credits = credits;
+    if (msgsnd(msgq_id, &ack, ACK_SIZE, !IPC_NOWAIT) == -1) {
+        perror("Error returning credits");
     }
-    return NULL;
 }
 
 // Function to handle process termination
 void processTermination(int pid) {
-    // Find process in process table
-    Process* process = NULL;
-    for (int i = 0; i < process_count; i++) {
-        if (process_table[i].pid == pid) {
-            process = &process_table[i];
-            break;
-        }
+    // The process exits right after reporting, so reaping it does not block for long
+    waitpid(pid, NULL, 0);
+
+    // Find process in process table, checking the running process first
+    int index = core->running_index;
+    if (index == -1 || core->table->pid[index] != pid) {
+        index = findProcessByPid(core->table, pid);
     }
-    
-    if (process == NULL) {
+
+    if (index == -1) {
         printf("Error: Process with PID %d not found\n", pid);
         return;
     }
-    
-    // Update process state
-    process->state = FINISHED;
-    process->finish_time = shm_clock->current_time;
-    process->remaining_time = 0;
-    
-    // Calculate statistics
-    int turnaround = process->finish_time - process->arrival_time;
-    double weighted_turnaround = (double)turnaround / process->runtime;
-    
-    turnaround_times[finished_count] = turnaround;
-    weighted_turnaround_times[finished_count] = weighted_turnaround;
-    finished_count++;
-    
-    // Log process termination
-    logProcess(process, "finished");
-    
-    printf("\n--> Process %d finished at time %d <--\n", process->id, shm_clock->current_time);
-    
-    // If this was the running process, set running_process to NULL
-    if (running_process == process) {
-        running_process = NULL;
-    }
-    
-    // Schedule next process
-    scheduleProcess();
+
+    // The process only exits at the end of a CPU burst; the core moves it to
+    // the I/O device or finishes it
+    schedSetTime(core, shm_clock->current_time);
+    schedCompleteBurst(core, index);
 }
 
-// Function to update waiting times for all processes
-void updateWaitingTimes() {
-    int current_time = shm_clock->current_time;
-    int time_diff = current_time - last_clock;
-    
-    if (time_diff <= 0) return;
-    
-    // If no process is running, increment idle time
-    if (running_process == NULL) {
-        idle_time += time_diff;
-    }
-    
-    // Update waiting time for all ready processes
-    for (int i = 0; i < process_count; i++) {
-        if (process_table[i].state == READY) {
-            process_table[i].waiting_time += time_diff;
-        }
+// Function to carry out a state change the core made: log it, trace it and
+// start, stop or resume the process behind it
+void handleCoreEvent(void* context, int type, int index) {
+    Process* process = &core->table->records[index];
+    int now = shm_clock->current_time;
+
+    switch (type) {
+    case EVENT_ARRIVAL:
+        printf("Process %d arrived at time %d\n", process->id, now);
+        recordEvent(process->arrival_time, EVENT_ARRIVAL, process->id, process->remaining_time);
+        break;
+    case EVENT_DISPATCH:
+    case EVENT_RESUME:
+        logProcess(process, type == EVENT_DISPATCH ? "started" : "resumed");
+        recordEvent(now, type, process->id, process->remaining_time);
+        launchProcess(process);
+        break;
+    case EVENT_PREEMPT:
+        signalProcess(process, SIGSTOP);
+        logProcess(process, "stopped");
+        recordEvent(now, EVENT_PREEMPT, process->id, process->remaining_time);
+        break;
+    case EVENT_BLOCK:
+        // The old pid is gone; clearing it keeps a late duplicate exit report from matching
+        setProcessPid(core->table, index, 0);
+        logProcess(process, "blocked");
+        recordEvent(now, EVENT_BLOCK, process->id, process->bursts[process->burst_index]);
+        break;
+    case EVENT_RELEASE:
+        logProcess(process, "released");
+        recordEvent(now, EVENT_RELEASE, process->id, process->remaining_time);
+        break;
+    case EVENT_IO_DONE:
+        logProcess(process, "unblocked");
+        recordEvent(process->ready_since, EVENT_IO_DONE, process->id, process->remaining_time);
+        break;
+    case EVENT_FINISH:
+        logProcess(process, "finished");
+        recordEvent(process->finish_time, EVENT_FINISH, process->id, 0);
+        printf("\n--> Process %d finished at time %d <--\n", process->id, now);
+        break;
     }
-    
-    last_clock = current_time;
-    total_runtime += time_diff;
 }
 
-// Function to run a process
-void runProcess(Process* process) {
-    // If process is starting for the first time
-    if (process->start_time == -1) {
-        process->start_time = shm_clock->current_time;
-        process->state = RUNNING;
-        logProcess(process, "started");
+// Function to start or resume the process behind a dispatch
+void launchProcess(Process* process) {
+    // A preempted real job carries on where it was stopped; everything else
+    // is forked afresh with the time it has left
+    int index = process->table_index;
+    int pid = core->table->pid[index];
+    long long fork_start = monotonicNs();
+    if (commands[index] != NULL && pid > 0) {
+        signalProcess(process, SIGCONT);
     } else {
-        // Process is resuming
-        process->state = RUNNING;
-        logProcess(process, "resumed");
+        int parent_pid = getpid();
+        pid = fork();
+        if (pid == 0) {
+            // Child process, which must not outlive the scheduler
+            dieWithParent(SIGKILL, parent_pid);
+
+            if (commands[index] != NULL) {
+                execRealJob(commands[index]);
+            }
+
+            char remaining_time_str[10];
+            sprintf(remaining_time_str, "%d", process->burst_remaining);
+
+            execl("./process", "process", remaining_time_str, NULL);
+            perror("Error executing process");
+            exit(1);
+        }
+
+        // Either side may get here first; the group must exist before it is signalled
+        if (commands[index] != NULL) {
+            setpgid(pid, pid);
+        }
+    }
+
+    recordLatency(&dispatch_latency, monotonicNs() - fork_start);
+
+    setProcessPid(core->table, index, pid);
+    publishStats();
+}
+
+// Function to run the command line of a real job in the freshly forked child.
+// The job leads its own process group, so stopping and resuming the group
+// reaches anything the command starts.
+void execRealJob(const char* command) {
+    setpgid(0, 0);
+
+    if (real_cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(real_cpu, &cpus);
+        if (sched_setaffinity(0, sizeof(cpus), &cpus) == -1) {
+            perror("Error pinning real job");
+        }
+    }
+
+    execl("/bin/sh", "sh", "-c", command, NULL);
+    perror("Error executing real job");
+    exit(1);
+}
+
+// Function to send a signal to a process, or to the whole group of a real job
+void signalProcess(Process* process, int signum) {
+    int pid = core->table->pid[process->table_index];
+    kill(commands[process->table_index] != NULL ? -pid : pid, signum);
+}
+
+// Function to notice that the running real job exited. Unlike ./process it
+// sends no termination message, so the scheduler reaps it and keeps the
+// resources it used.
+void checkRealJobExit() {
+    Process* running = runningProcess();
+    if (running == NULL || commands[core->running_index] == NULL) return;
+
+    int pid = core->table->pid[core->running_index];
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, WNOHANG, &usage) != pid) return;
+
+    RealUsage* measured = &real_usage[core->running_index];
+    measured->measured = true;
+    measured->cpu_time = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+                         usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+    measured->voluntary_switches = usage.ru_nvcsw;
+    measured->involuntary_switches = usage.ru_nivcsw;
+    measured->max_rss_kb = usage.ru_maxrss;
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        printf("Warning: real job of process %d exited with status %d\n", running->id, status);
+    }
+
+    processTermination(pid);
+}
+
+// Function to write the snapshot from the forked checkpoint writer. It runs on
+// a private copy of the scheduler's memory, so it may rewrite the running
+// process as if it had been preempted at the snapshot time.
+int writeCheckpointImage() {
+    int now = shm_clock->current_time;
+    int count = core->table->count;
+    Checkpoint checkpoint;
+    CheckpointHeader* header = &checkpoint.header;
+
+    checkpoint.records = core->table->records;
+    checkpoint.ready_order = malloc((count + 1) * sizeof(int));
+    checkpoint.io_order = malloc((core->io_queue->size + 1) * sizeof(int));
+    checkpoint.turnaround = core->turnaround_times;
+    checkpoint.weighted_turnaround = core->weighted_turnaround_times;
+    checkpoint.usage = real_usage;
+    checkpoint.groups = core->groups;
+    checkpoint.quantum_samples = core->quantum_samples;
+
+    // Command lines back to back, an empty string for each simulated process
+    header->command_bytes = 0;
+    for (int i = 0; i < count; i++) {
+        header->command_bytes += (commands[i] != NULL ? strlen(commands[i]) : 0) + 1;
+    }
+    checkpoint.commands = malloc(header->command_bytes + 1);
+    char* cursor = checkpoint.commands;
+    for (int i = 0; i < count; i++) {
+        const char* command = commands[i] != NULL ? commands[i] : "";
+        strcpy(cursor, command);
+        cursor += strlen(command) + 1;
+    }
+
+    header->ready_count = core->policy->readyOrder(core, checkpoint.ready_order);
+    Process* running = runningProcess();
+    if (running != NULL) {
+        int ran = now - running->last_run_time;
+        running->remaining_time -= ran;
+        running->burst_remaining -= ran;
+        running->state = STOPPED;
+        running->ready_since = now;
+        running->prempted = true;
+        checkpoint.ready_order[header->ready_count++] = core->running_index;
+    }
+
+    header->io_count = collectCircularQueue(core->io_queue, checkpoint.io_order);
+
+    header->magic = CHECKPOINT_MAGIC;
+    header->version = CHECKPOINT_VERSION;
+    header->algorithm = algorithm;
+    header->quantum = quantum;
+    header->time = now;
+    header->process_count = count;
+    header->trace_position = trace_position;
+    header->io_index = core->io_index;
+    header->io_done_time = core->io_done_time;
+    header->io_busy_time = core->io_busy_time;
+    header->total_runtime = core->total_runtime;
+    header->idle_time = core->idle_time;
+    header->finished_count = core->finished_count;
+    header->dispatches = core->dispatches;
+    header->preemptions = core->preemptions;
+    header->total_finished_waiting = core->total_finished_waiting;
+    header->total_finished_wta = core->total_finished_wta;
+    header->share_clock = core->share_clock;
+    header->active_tickets = core->active_tickets;
+    header->stride_pass = core->stride_pass;
+    header->lottery_seed = core->lottery_seed;
+    header->group_count = core->group_count;
+    header->group_pass = core->group_pass;
+    memcpy(header->class_estimate, core->class_estimate, sizeof(core->class_estimate));
+    memcpy(header->class_seen, core->class_seen, sizeof(core->class_seen));
+    header->overall_estimate = core->overall_estimate;
+    header->overall_seen = core->overall_seen;
+    memcpy(header->prediction_count, core->prediction_count, sizeof(core->prediction_count));
+    memcpy(header->prediction_abs_error, core->prediction_abs_error, sizeof(core->prediction_abs_error));
+    header->prediction_bias = core->prediction_bias;
+    header->prediction_rel_error = core->prediction_rel_error;
+    memcpy(header->burst_window, core->burst_window, sizeof(core->burst_window));
+    header->burst_window_count = core->burst_window_count;
+    header->burst_window_next = core->burst_window_next;
+    header->current_quantum = core->current_quantum;
+    header->slice_total = core->slice_total;
+    header->slice_count = core->slice_count;
+    header->slice_min = core->slice_min;
+    header->slice_max = core->slice_max;
+    header->quantum_sample_count = core->quantum_sample_count;
+    header->arrivals_received = arrivals_received;
+    header->late_arrivals = late_arrivals;
+    header->total_lateness = total_lateness;
+    header->max_lateness = max_lateness;
+    memcpy(header->lateness_buckets, lateness_buckets, sizeof(lateness_buckets));
+
+    return saveCheckpoint(CHECKPOINT_FILE, &checkpoint);
+}
+
+// Function to snapshot the scheduler state. The snapshot is written by a forked
+// child working on a copy-on-write image, so the scheduler carries on at once.
+void takeCheckpoint() {
+    // At most one writer at a time; skip this round if the last one is still busy
+    if (checkpoint_pid > 0) {
+        if (waitpid(checkpoint_pid, NULL, WNOHANG) == 0) return;
+        checkpoint_pid = 0;
     }
-    
-    // Fork and exec the process
+
+    schedSetTime(core, shm_clock->current_time);
     int pid = fork();
+    if (pid == -1) {
+        perror("Error starting checkpoint writer");
+        return;
+    }
+
     if (pid == 0) {
-        // Child process
-        char remaining_time_str[10];
-        sprintf(remaining_time_str, "%d", process->remaining_time);
-        
-        execl("./process", "process", remaining_time_str, NULL);
-        perror("Error executing process");
+        // _exit() leaves the parent's stdio and trace buffers alone
+        _exit(writeCheckpointImage() == 0 ? 0 : 1);
+    }
+
+    checkpoint_pid = pid;
+    last_checkpoint_time = shm_clock->current_time;
+}
+
+
+// Function to rebuild the process table, queues and statistics from a snapshot
+void restoreCheckpoint(const char* path) {
+    Checkpoint checkpoint;
+    if (loadCheckpoint(path, &checkpoint) == -1) {
         exit(1);
     }
-    
-    process->pid = pid;
-    process->last_run_time = shm_clock->current_time;
-    running_process = process;
-    
-    // Wait for process to finish or be preempted
-    if (algorithm == HPF) {
-        // Non-preemptive HPF: wait for process to finish
-        int status;
-        waitpid(pid, &status, 0);
-        processTermination(pid);
-    } else if (algorithm == SRTN) {
-        // SRTN: check for preemption on each clock tick or process arrival
-        // This is handled in the main loop
-    } else if (algorithm == RR) {
-        // RR: run for quantum time
-        sleep(quantum);
-        
-        // Check if process has finished
-        int status;
-        if (waitpid(pid, &status, WNOHANG) > 0) {
-            processTermination(pid);
-        } else {
-            // Process has not finished, preempt it
-            kill(pid, SIGSTOP);
-            stopProcess(process);
-        }
+
+    CheckpointHeader* header = &checkpoint.header;
+    if (header->algorithm != algorithm) {
+        printf("Error: checkpoint was taken with algorithm %d, not %d\n", header->algorithm, algorithm);
+        exit(1);
+    }
+    if (USES_QUANTUM(algorithm) && header->quantum != quantum) {
+        printf("Error: checkpoint was taken with quantum %d, not %d\n", header->quantum, quantum);
+        exit(1);
+    }
+
+    // Groups first, so the records join them in their original slots with the
+    // passes they had reached
+    for (int i = 0; i < header->group_count; i++) {
+        int group = joinGroup(core, checkpoint.groups[i].name, checkpoint.groups[i].weight);
+        core->groups[group].pass = checkpoint.groups[i].pass;
     }
+    core->group_pass = header->group_pass;
+
+    // Processes that were running when the snapshot was taken come back as preempted
+    for (int i = 0; i < header->process_count; i++) {
+        Process record = checkpoint.records[i];
+        record.pid = 0;
+        record.group = joinGroup(core, record.group_name, record.group_weight);
+        addProcessToTable(core->table, record);
+    }
+    for (int i = 0; i < header->ready_count; i++) {
+        schedEnqueue(core, checkpoint.ready_order[i]);
+    }
+    for (int i = 0; i < header->io_count; i++) {
+        enqueueCircularQueue(core->io_queue, checkpoint.io_order[i]);
+    }
+    schedRebuildDependencies(core);
+    core->io_index = header->io_index;
+    core->io_done_time = header->io_done_time;
+    core->io_busy_time = header->io_busy_time;
+    if (core->io_index != -1) {
+        addTimer(core->timers, &core->io_timer, core->io_done_time);
+    }
+
+    // Accumulated statistics
+    int capacity = header->process_count > 0 ? header->process_count : 1;
+    core->turnaround_times = realloc(core->turnaround_times, capacity * sizeof(double));
+    core->weighted_turnaround_times = realloc(core->weighted_turnaround_times, capacity * sizeof(double));
+
+    // Real jobs that had started are run again from the beginning
+    commands = realloc(commands, capacity * sizeof(char*));
+    real_usage = realloc(real_usage, capacity * sizeof(RealUsage));
+    const char* cursor = checkpoint.commands;
+    for (int i = 0; i < header->process_count; i++) {
+        commands[i] = cursor[0] != '\0' ? strdup(cursor) : NULL;
+        cursor += strlen(cursor) + 1;
+    }
+    memcpy(real_usage, checkpoint.usage, header->process_count * sizeof(RealUsage));
+    memcpy(core->turnaround_times, checkpoint.turnaround, header->finished_count * sizeof(double));
+    memcpy(core->weighted_turnaround_times, checkpoint.weighted_turnaround,
+           header->finished_count * sizeof(double));
+    core->finished_count = header->finished_count;
+    core->total_runtime = header->total_runtime;
+    core->idle_time = header->idle_time;
+    core->dispatches = header->dispatches;
+    core->preemptions = header->preemptions;
+    core->total_finished_waiting = header->total_finished_waiting;
+    core->total_finished_wta = header->total_finished_wta;
+    core->share_clock = header->share_clock;
+    core->active_tickets = header->active_tickets;
+    core->stride_pass = header->stride_pass;
+    core->lottery_seed = header->lottery_seed;
+    memcpy(core->class_estimate, header->class_estimate, sizeof(core->class_estimate));
+    memcpy(core->class_seen, header->class_seen, sizeof(core->class_seen));
+    core->overall_estimate = header->overall_estimate;
+    core->overall_seen = header->overall_seen;
+    memcpy(core->prediction_count, header->prediction_count, sizeof(core->prediction_count));
+    memcpy(core->prediction_abs_error, header->prediction_abs_error, sizeof(core->prediction_abs_error));
+    core->prediction_bias = header->prediction_bias;
+    core->prediction_rel_error = header->prediction_rel_error;
+    memcpy(core->burst_window, header->burst_window, sizeof(core->burst_window));
+    core->burst_window_count = header->burst_window_count;
+    core->burst_window_next = header->burst_window_next;
+    core->current_quantum = header->current_quantum;
+    core->slice_total = header->slice_total;
+    core->slice_count = header->slice_count;
+    core->slice_min = header->slice_min;
+    core->slice_max = header->slice_max;
+    core->quantum_samples = realloc(core->quantum_samples,
+                                    (header->quantum_sample_count + 1) * sizeof(QuantumSample));
+    memcpy(core->quantum_samples, checkpoint.quantum_samples,
+           header->quantum_sample_count * sizeof(QuantumSample));
+    core->quantum_sample_count = header->quantum_sample_count;
+    core->quantum_sample_capacity = header->quantum_sample_count + 1;
+    core->share_last_time = header->time;
+    core->last_clock = header->time;
+    trace_position = header->trace_position;
+    arrivals_received = header->arrivals_received;
+    late_arrivals = header->late_arrivals;
+    total_lateness = header->total_lateness;
+    max_lateness = header->max_lateness;
+    memcpy(lateness_buckets, header->lateness_buckets, sizeof(lateness_buckets));
+    last_checkpoint_time = header->time;
+    resumed_at = header->time;
+
+    fprintf(log_file, "#Resumed at time %d from %s with %d processes (%d finished)\n",
+            header->time, path, header->process_count, header->finished_count);
+    printf("Resumed from %s at time %d\n", path, header->time);
+    freeCheckpoint(&checkpoint);
+}
+
+// Function to attach the statistics page process_generator created for external observers
+int attachStatsShm() {
+    stats_shm_id = getIpcId(ENV_STATS_SHM);
+    stats_page = (SchedStats *)shmat(stats_shm_id, NULL, 0);
+    if ((void *)stats_page == (void *)-1) {
+        perror("Error attaching statistics page");
+        stats_page = NULL;
+        return -1;
+    }
+
+    publishStats();
+    return stats_shm_id;
 }
 
-// Function to stop a process
-void stopProcess(Process* process) {
-    process->state = STOPPED;
-    process->remaining_time -= (shm_clock->current_time - process->last_run_time);
-    if (process->remaining_time < 0) process->remaining_time = 0;
-    process->prempted = true;
-    
-    logProcess(process, "stopped");
-    
-    // Add process back to appropriate queue
-    if (algorithm == SRTN) {
-        insertRuntimePriorityQueue(srtn_queue, *process);
-    } else if (algorithm == RR) {
-        enqueueCircularQueue(rr_queue, *process);
-    }
-    
-    // Set running_process to NULL
-    running_process = NULL;
-    
-    // Schedule next process
-    scheduleProcess();
+// Function to publish the current counters to the statistics page
+void publishStats() {
+    if (stats_page == NULL) return;
+
+    // Refresh the per-second dispatch rate once per clock tick
+    static int last_rate_time = -1;
+    int now = shm_clock->current_time;
+    if (now != last_rate_time) {
+        if (last_rate_time != -1) {
+            dispatch_rate = (int)((core->dispatches - last_second_dispatches) / (now - last_rate_time));
+        }
+        last_second_dispatches = core->dispatches;
+        last_rate_time = now;
+    }
+
+    SchedCoreStats stats;
+    schedGetStats(core, &stats);
+
+    // Odd sequence number marks the page as being written
+    stats_page->seq++;
+    __sync_synchronize();
+
+    stats_page->algorithm = algorithm;
+    stats_page->quantum = core->adaptive_quantum ? core->current_quantum : quantum;
+    stats_page->current_time = now;
+    stats_page->process_count = stats.jobs;
+    stats_page->finished_count = stats.finished;
+    stats_page->running_id = core->running_index != -1 ? core->table->records[core->running_index].id : -1;
+    stats_page->blocked_count = stats.blocked;
+    memset(stats_page->queue_depth, 0, sizeof(stats_page->queue_depth));
+    stats_page->queue_depth[algorithm] = readyQueueSize(core);
+    stats_page->dispatches = stats.dispatches;
+    stats_page->preemptions = stats.preemptions;
+    stats_page->dispatches_per_sec = dispatch_rate;
+    stats_page->cpu_utilization = stats.cpu_utilization;
+    stats_page->device_utilization = stats.device_utilization;
+    stats_page->avg_waiting = stats.avg_waiting;
+    stats_page->avg_wta = stats.avg_wta;
+
+    __sync_synchronize();
+    stats_page->seq++;
 }
 
 // Function to log process state changes
 void logProcess(Process* process, const char* state) {
-    fprintf(log_file, "At time %d process %d %s arr %d total %d remain %d wait %d", 
-            shm_clock->current_time, process->id, state, process->arrival_time, 
-            process->runtime, process->remaining_time, process->waiting_time);
-    
+    long long log_start = monotonicNs();
+    fprintf(log_file, "At time %d process %d %s arr %d total %d remain %d wait %d",
+            shm_clock->current_time, process->id, state, process->arrival_time,
+            process->runtime, process->remaining_time, currentWaitingTime(core, process));
+
     // Add TA and WTA for finished processes
     if (strcmp(state, "finished") == 0) {
         int turnaround = process->finish_time - process->arrival_time;
         double weighted_turnaround = (double)turnaround / process->runtime;
         fprintf(log_file, " TA %d WTA %.2f", turnaround, weighted_turnaround);
     }
-    
+
     fprintf(log_file, "\n");
     fflush(log_file);
+    recordLatency(&log_latency, monotonicNs() - log_start);
+}
+
+// Function to list the processes in one state; the per-state counters let
+// empty lists skip the scan, and the scan itself only reads the state column
+void logProcessesInState(const char* label, int state) {
+    fprintf(log_file, "  %s processes: ", label);
+    if (core->table->state_count[state] == 0) {
+        fprintf(log_file, "none\n");
+        return;
+    }
+
+    const unsigned char* column = core->table->state;
+    for (int i = 0; i < core->table->count; i++) {
+        if (column[i] == state) {
+            fprintf(log_file, "%d ", core->table->records[i].id);
+        }
+    }
+    fprintf(log_file, "\n");
 }
 
 // Function to log system state every second
 void logSystemState() {
     static int last_log_time = -1;
-    
+
     // Only log once per second
     if (shm_clock->current_time == last_log_time) {
         return;
     }
-    
+
     last_log_time = shm_clock->current_time;
-    
+    long long log_start = monotonicNs();
+
     fprintf(log_file, "At time %d: System state:\n", shm_clock->current_time);
-    
+
     // Log running process if any
-    if (running_process != NULL) {
-        fprintf(log_file, "  Running process: %d (remaining: %d)\n", 
-                running_process->id, running_process->remaining_time);
+    Process* running = runningProcess();
+    if (running != NULL) {
+        fprintf(log_file, "  Running process: %d (remaining: %d)\n",
+                running->id, running->remaining_time);
     } else {
         fprintf(log_file, "  No process running\n");
     }
-    
-    // Log ready processes
-    fprintf(log_file, "  Ready processes: ");
-    int ready_count = 0;
-    for (int i = 0; i < process_count; i++) {
-        if (process_table[i].state == READY) {
-            fprintf(log_file, "%d ", process_table[i].id);
-            ready_count++;
-        }
-    }
-    if (ready_count == 0) {
-        fprintf(log_file, "none");
-    }
-    fprintf(log_file, "\n");
-    
-    // Log blocked processes (if any)
-    fprintf(log_file, "  Blocked processes: ");
-    int blocked_count = 0;
-    for (int i = 0; i < process_count; i++) {
-        if (process_table[i].state == STOPPED) {
-            fprintf(log_file, "%d ", process_table[i].id);
-            blocked_count++;
-        }
-    }
-    if (blocked_count == 0) {
-        fprintf(log_file, "none");
-    }
-    fprintf(log_file, "\n");
-    
-    // Log finished processes
-    fprintf(log_file, "  Finished processes: ");
-    int finished_count_local = 0;
-    for (int i = 0; i < process_count; i++) {
-        if (process_table[i].state == FINISHED) {
-            fprintf(log_file, "%d ", process_table[i].id);
-            finished_count_local++;
-        }
-    }
-    if (finished_count_local == 0) {
-        fprintf(log_file, "none");
+
+    logProcessesInState("Ready", READY);
+    logProcessesInState("Preempted", STOPPED);
+    logProcessesInState("Blocked", BLOCKED);
+    logProcessesInState("Finished", FINISHED);
+    if (core->has_deps) {
+        logProcessesInState("Pending", PENDING);
     }
-    fprintf(log_file, "\n");
-    
+
     // Log queue sizes
-    if (algorithm == HPF) {
-        fprintf(log_file, "  HPF Queue size: %d\n", hpf_queue->size);
-    } else if (algorithm == SRTN) {
-        fprintf(log_file, "  SRTN Queue size: %d\n", srtn_queue->size);
-    } else if (algorithm == RR) {
-        fprintf(log_file, "  RR Queue size: %d\n", rr_queue->size);
-    }
-    
+    core->policy->logQueue(core, log_file);
+    recordEvent(shm_clock->current_time, EVENT_QUEUE_DEPTH, -1, readyQueueSize(core));
+    flushTrace();
+
     // Log CPU utilization so far
     double cpu_util = 0;
-    if (total_runtime > 0) {
-        cpu_util = 100.0 * (total_runtime - idle_time) / total_runtime;
+    if (core->total_runtime > 0) {
+        cpu_util = 100.0 * (core->total_runtime - core->idle_time) / core->total_runtime;
     }
     fprintf(log_file, "  CPU utilization: %.2f%%\n", cpu_util);
-    
+    fprintf(log_file, "  I/O device: %s, %d waiting\n",
+            core->io_index != -1 ? "busy" : "idle", core->io_queue->size);
+
     fprintf(log_file, "-----------------------------------\n");
     fflush(log_file);
+    recordLatency(&log_latency, monotonicNs() - log_start);
 }
 
 // Function to display the currently running process
 void displayRunningProcess() {
     static int last_display_time = -1;
-    
+
     // Only display once per second
     if (shm_clock->current_time == last_display_time) {
         return;
     }
-    
+
     last_display_time = shm_clock->current_time;
-    
+
     printf("\n===== Time: %d =====\n", shm_clock->current_time);
-    if (running_process != NULL) {
-        printf("Running Process: ID=%d, Priority=%d, Remaining Time=%d\n", 
-               running_process->id, 
-               running_process->priority,
-               running_process->remaining_time);
+    Process* running = runningProcess();
+    if (running != NULL) {
+        printf("Running Process: ID=%d, Priority=%d, Remaining Time=%d\n",
+               running->id,
+               running->priority,
+               running->remaining_time);
     } else {
         printf("No process running (CPU idle)\n");
     }
     printf("===================\n");
 }
 
-// Function to schedule processes based on algorithm
-void scheduleProcess() {
-    updateWaitingTimes();
-    
-    // If a process is already running, return (for non-preemptive algorithms)
-    if (running_process != NULL && algorithm == HPF) {
-        return;
+// Function to handle a timer that expired on the scheduler's wheel
+void fireTimer(Timer* timer) {
+    int now = shm_clock->current_time;
+
+    if (timer->type == TIMER_STATS) {
+        schedSetTime(core, now);
+        logSystemState();
+        displayRunningProcess();
+        publishStats();
+        addTimer(timers, &stats_timer, now + 1);
+    } else if (timer->type == TIMER_CHECKPOINT) {
+        takeCheckpoint();
+
+        // A round skipped because the last writer is still busy is retried next tick
+        int next = last_checkpoint_time + checkpoint_every;
+        addTimer(timers, &checkpoint_timer, next > now ? next : now + 1);
     }
-    
-    Process next_process;
-    bool found_next = false;
-    
-    if (algorithm == HPF) {
-        // Highest Priority First (non-preemptive)
-        if (hpf_queue->size > 0) {
-            next_process = removePriorityPriorityQueue(hpf_queue);
-            found_next = true;
-        }
-    } else if (algorithm == SRTN) {
-        // Shortest Remaining Time Next
-        if (srtn_queue->size > 0) {
-            // Get process with shortest remaining time
-            Process shortest = removeRuntimePriorityQueue(srtn_queue);
-            
-            // If a process is running, compare remaining times
-            if (running_process != NULL) {
-                // If running process has shorter or equal remaining time, keep it running
-                if (running_process->remaining_time <= shortest.remaining_time) {
-                    // Put shortest back in the queue
-                    insertRuntimePriorityQueue(srtn_queue, shortest);
-                    return;
-                } else {
-                    // Preempt the running process
-                    kill(running_process->pid, SIGSTOP);
-                    stopProcess(running_process);
-                    
-                    // Update shortest process state
-                    Process* process_ptr = findProcessById(shortest.id);
-                    if (process_ptr != NULL) {
-                        process_ptr->state = READY;
-                        next_process = *process_ptr;
-                        found_next = true;
-                    }
-                }
-            } else {
-                // No process running, just run the shortest
-                Process* process_ptr = findProcessById(shortest.id);
-                if (process_ptr != NULL) {
-                    process_ptr->state = READY;
-                    next_process = *process_ptr;
-                    found_next = true;
-                }
-            }
-        }
-    } else if (algorithm == RR) {
-        // Round Robin
-        if (!isCircularQueueEmpty(rr_queue)) {
-            next_process = dequeueCircularQueue(rr_queue);
-            found_next = true;
-        }
+}
+
+// Function to compare the resources real jobs used with the runtime the trace
+// predicted for them, so the simulated figures can be checked against them
+void reportRealJobs() {
+    int real_count = 0;
+    long predicted = 0;
+    double cpu_time = 0;
+    long switches = 0;
+    long max_rss_kb = 0;
+    for (int i = 0; i < core->table->count; i++) {
+        if (!real_usage[i].measured) continue;
+        real_count++;
+        predicted += core->table->records[i].runtime;
+        cpu_time += real_usage[i].cpu_time;
+        switches += real_usage[i].voluntary_switches + real_usage[i].involuntary_switches;
+        if (real_usage[i].max_rss_kb > max_rss_kb) max_rss_kb = real_usage[i].max_rss_kb;
+    }
+    if (real_count == 0) return;
+
+    fprintf(perf_file, "Real jobs = %d\n", real_count);
+    fprintf(perf_file, "Real CPU time = %.2f s (predicted %ld s)\n", cpu_time, predicted);
+    fprintf(perf_file, "Real context switches = %ld\n", switches);
+    fprintf(perf_file, "Real max RSS = %ld KB\n", max_rss_kb);
+
+    // Wall time is the clock time from first dispatch to exit, preemptions included
+    fprintf(perf_file, "\nMeasured real jobs:\n");
+    fprintf(perf_file, "%8s %9s %9s %8s %8s %8s %10s\n", "id", "predicted", "cpu_time", "wall",
+            "vol_cs", "invol_cs", "max_rss_kb");
+    for (int i = 0; i < core->table->count; i++) {
+        if (!real_usage[i].measured) continue;
+        Process* process = &core->table->records[i];
+        fprintf(perf_file, "%8d %9d %9.2f %8d %8ld %8ld %10ld\n", process->id, process->runtime,
+                real_usage[i].cpu_time, process->finish_time - process->start_time,
+                real_usage[i].voluntary_switches, real_usage[i].involuntary_switches,
+                real_usage[i].max_rss_kb);
     }
-    
-    // If a process was selected, run it
-    if (found_next) {
-        Process* process_ptr = findProcessById(next_process.id);
-        if (process_ptr != NULL) {
-            runProcess(process_ptr);
+}
+
+// Function to report how arrivals were delivered: the generator's window and
+// what it did when the window was full, and how late each job reached the
+// scheduler compared with its arrival_time. The lateness figures are kept in
+// snapshots; the generator's counters come from the generator that finished
+// the run, so after a resume they only cover the part since.
+void reportArrivalFlow() {
+    fprintf(perf_file, "\nArrival delivery:\n");
+    if (flow_reported) {
+        const char* overflow_names[] = OVERFLOW_NAMES;
+        if (resumed_at != -1) {
+            fprintf(perf_file, "Generator figures since the resume at time %d:\n", resumed_at);
         }
+        fprintf(perf_file, "Window = %d messages, %s when full\n",
+                generator_flow.window, overflow_names[generator_flow.overflow]);
+        fprintf(perf_file, "Arrival messages = %d (%d jobs coalesced)\n",
+                generator_flow.sent, generator_flow.coalesced);
+        fprintf(perf_file, "Dropped jobs = %d\n", generator_flow.dropped);
+        fprintf(perf_file, "Generator stalls = %d (%.2f ms waiting for credits)\n",
+                generator_flow.stalls, generator_flow.stall_ns / 1e6);
     }
+
+    fprintf(perf_file, "Late arrivals = %d of %d\n", late_arrivals, arrivals_received);
+    fprintf(perf_file, "Avg lateness = %.2f ticks (max %d)\n",
+            arrivals_received > 0 ? (double)total_lateness / arrivals_received : 0, max_lateness);
+    fprintf(perf_file, "Lateness ticks: 0 = %ld, 1 = %ld, 2-3 = %ld, 4-7 = %ld, 8+ = %ld\n",
+            lateness_buckets[0], lateness_buckets[1], lateness_buckets[2],
+            lateness_buckets[3], lateness_buckets[4]);
 }
 
 // Function to generate performance metrics
@@ -441,37 +830,71 @@ void generatePerformanceMetrics() {
         perror("Error opening performance file");
         exit(1);
     }
-    
+
+    int total_runtime = core->total_runtime;
+    int finished_count = core->finished_count;
+
     // Calculate CPU utilization
-    double cpu_utilization = 100.0 * (total_runtime - idle_time) / total_runtime;
-    
+    double cpu_utilization = 100.0 * (total_runtime - core->idle_time) / total_runtime;
+
     // Calculate average weighted turnaround time
     double avg_wta = 0;
     for (int i = 0; i < finished_count; i++) {
-        avg_wta += weighted_turnaround_times[i];
+        avg_wta += core->weighted_turnaround_times[i];
     }
     avg_wta /= finished_count;
-    
+
     // Calculate average waiting time
     double avg_waiting = 0;
-    for (int i = 0; i < process_count; i++) {
-        avg_waiting += process_table[i].waiting_time;
+    for (int i = 0; i < core->table->count; i++) {
+        avg_waiting += currentWaitingTime(core, &core->table->records[i]);
     }
-    avg_waiting /= process_count;
-    
+    avg_waiting /= core->table->count;
+
     // Calculate standard deviation for weighted turnaround time
     double std_wta = 0;
     for (int i = 0; i < finished_count; i++) {
-        std_wta += pow(weighted_turnaround_times[i] - avg_wta, 2);
+        std_wta += pow(core->weighted_turnaround_times[i] - avg_wta, 2);
     }
     std_wta = sqrt(std_wta / finished_count);
-    
+
     // Write metrics to file
     fprintf(perf_file, "CPU utilization = %.2f%%\n", cpu_utilization);
     fprintf(perf_file, "Avg WTA = %.2f\n", avg_wta);
     fprintf(perf_file, "Avg Waiting = %.2f\n", avg_waiting);
     fprintf(perf_file, "Std WTA = %.2f\n", std_wta);
-    
+
+    // Device and throughput figures matter once jobs have I/O bursts
+    fprintf(perf_file, "Device utilization = %.2f%%\n", 100.0 * deviceBusyTime(core) / total_runtime);
+    fprintf(perf_file, "Throughput = %.3f processes/second\n", (double)finished_count / total_runtime);
+
+    if (core->adaptive_quantum) {
+        reportQuantum(core, perf_file);
+    }
+    if (core->policy->report != NULL) {
+        core->policy->report(core, perf_file, avg_wta);
+    }
+
+    if (core->has_deps) {
+        reportDependencies(core, perf_file);
+    }
+
+    // Per-group figures matter once jobs are spread over more than one group
+    if (core->group_count > 1) {
+        reportGroups(core, perf_file);
+    }
+
+    reportRealJobs();
+    reportArrivalFlow();
+
+    // Control-plane overhead, in wall-clock nanoseconds
+    fprintf(perf_file, "\nDecision latency:\n");
+    printLatencyHeader(perf_file);
+    printLatency(perf_file, "ipc_receive", &ipc_latency);
+    printLatency(perf_file, "queue_op", &core->queue_latency);
+    printLatency(perf_file, "dispatch", &dispatch_latency);
+    printLatency(perf_file, "log", &log_latency);
+
     fclose(perf_file);
 }
 
@@ -480,94 +903,147 @@ int main(int argc, char *argv[]) {
         printf("Usage: %s <algorithm> [quantum]\n", argv[0]);
         exit(1);
     }
-    
+
     // Parse arguments
     algorithm = atoi(argv[1]);
-    if (algorithm == RR && argc < 3) {
-        printf("Error: Round Robin requires a time quantum\n");
+    const SchedPolicy* policy = findPolicy(algorithm);
+    if (policy == NULL) {
+        printf("Error: unknown algorithm %d\n", algorithm);
         exit(1);
     }
-    
-    if (algorithm == RR) {
+
+    if (policy->time_sliced && argc < 3) {
+        printf("Error: %s requires a time quantum\n", policy->name);
+        exit(1);
+    }
+
+    if (policy->time_sliced) {
         quantum = atoi(argv[2]);
+        if (quantum < 0) {
+            printf("Error: the time quantum must be positive, or %d for adaptive\n", ADAPTIVE_QUANTUM);
+            exit(1);
+        }
     }
-    
+
     // Initialize scheduler
     initScheduler(algorithm);
-    
-    // Main loop
-    Message msg;
+
+    // A resumed run starts with processes already in the ready queue
+    schedSchedule(core);
+
+    // Main loop. Credits on the queue are for the generator, so they are
+    // skipped while everything else is taken in the order it was sent.
+    union {
+        Message msg;
+        BatchMessage batch;
+    } inbox;
+    Message* msg = &inbox.msg;
+    size_t inbox_size = sizeof(inbox) - sizeof(long);
+    bool generator_done = false;
     while (1) {
-        // Log system state every second
-        logSystemState();
-        
-        displayRunningProcess();
-        
-        // Check for messages
-        if (msgrcv(msgq_id, &msg, sizeof(msg.process), 0, IPC_NOWAIT) != -1) {
-            if (msg.mtype == PROCESS_ARRIVAL) {
-                processArrival(msg.process);
-            } else if (msg.mtype == PROCESS_TERMINATION) {
-                processTermination(msg.process.id);
+        // Drain pending messages
+        int credits = 0;
+        while (msgrcv(msgq_id, &inbox, inbox_size, ARRIVAL_ACK, IPC_NOWAIT | MSG_EXCEPT) != -1) {
+            if (inbox.msg.mtype == PROCESS_BATCH) {
+                recordLatency(&ipc_latency, monotonicNs() - inbox.batch.sent_ns);
+
+                // The whole batch arrived together, so it is scheduled once
+                for (int i = 0; i < inbox.batch.count; i++) {
+                    admitProcess(inbox.batch.processes[i], "");
+                }
+                trace_position = inbox.batch.position + 1;
+                schedSchedule(core);
+                credits++;
+                continue;
             }
-        }
-        
-        // Update waiting times
-        updateWaitingTimes();
-        
-        // Check if all processes have finished
-        int all_finished = 1;
-        for (int i = 0; i < process_count; i++) {
-            if (process_table[i].state != FINISHED) {
-                all_finished = 0;
-                break;
+
+            recordLatency(&ipc_latency, monotonicNs() - msg->sent_ns);
+
+            if (msg->mtype == PROCESS_ARRIVAL) {
+                // Jobs before this one in the arrival order were sent before it or dropped
+                trace_position = msg->position + 1;
+                processArrival(msg->process, msg->command);
+                credits++;
+            } else if (msg->mtype == PROCESS_TERMINATION) {
+                processTermination(msg->process.id);
+            } else if (msg->mtype == GENERATOR_DONE) {
+                generator_flow = msg->flow;
+                flow_reported = true;
+                generator_done = true;
+
+                // Jobs whose parents were dropped would otherwise wait forever
+                schedSetTime(core, shm_clock->current_time);
+                schedReleaseOrphans(core);
             }
         }
-        
-        if (all_finished && process_count > 0) {
+        if (credits > 0) {
+            returnCredits(credits);
+        }
+
+        // A real job reports its exit through wait4() rather than a message
+        checkRealJobExit();
+
+        // Fire the periodic log and snapshots, then the quantum expiries and
+        // I/O completions that fell due since the last pass
+        advanceTimerWheel(timers, shm_clock->current_time, fireTimer);
+        schedAdvance(core, shm_clock->current_time);
+
+        // Check if all processes have finished, using the per-state counters
+        int all_finished = core->table->state_count[FINISHED] == core->table->count;
+
+        if (all_finished && generator_done) {
             // Find the last process to finish
             int last_finish_time = 0;
             int last_process_id = -1;
-            
-            for (int i = 0; i < process_count; i++) {
-                if (process_table[i].finish_time > last_finish_time) {
-                    last_finish_time = process_table[i].finish_time;
-                    last_process_id = process_table[i].id;
+
+            for (int i = 0; i < core->table->count; i++) {
+                if (core->table->records[i].finish_time > last_finish_time) {
+                    last_finish_time = core->table->records[i].finish_time;
+                    last_process_id = core->table->records[i].id;
                 }
             }
-            
+
             printf("\n========================================\n");
             printf("ALL PROCESSES COMPLETED\n");
-            printf("Last process (ID=%d) finished at time %d\n", 
+            printf("Last process (ID=%d) finished at time %d\n",
                    last_process_id, last_finish_time);
             printf("Total execution time: %d seconds\n", last_finish_time);
             printf("========================================\n\n");
-            
+
             break;
         }
-        
+
         // Sleep for a short time
         usleep(100000); // 100ms
     }
-    
+
+    // A finished run leaves nothing to resume
+    if (checkpoint_pid > 0) {
+        waitpid(checkpoint_pid, NULL, 0);
+    }
+    if (checkpoint_every > 0) {
+        unlink(CHECKPOINT_FILE);
+    }
+
     // Generate performance metrics
     generatePerformanceMetrics();
-    
+
+    // Publish the final counters; the page goes away with the last observer
+    if (stats_page != NULL) {
+        publishStats();
+        shmdt(stats_page);
+    }
+
     // Clean up
     fclose(log_file);
-    free(process_table);
-    free(turnaround_times);
-    free(weighted_turnaround_times);
-    
-    // Free data structures
-    if (algorithm == HPF) {
-        destroyPriorityQueue(hpf_queue);
-    } else if (algorithm == SRTN) {
-        destroyPriorityQueue(srtn_queue);
-    } else if (algorithm == RR) {
-        free(rr_queue->array);
-        free(rr_queue);
-    }
-    
+    closeTrace();
+    for (int i = 0; i < core->table->count; i++) {
+        free(commands[i]);
+    }
+    free(commands);
+    free(real_usage);
+    schedDestroy(core);
+    destroyTimerWheel(timers);
+
     return 0;
 }
@@ -0,0 +1,223 @@
+#include "headers.h"
+#include <pthread.h>
+
+// Virtual-time replay of a trace through the scheduling core (see
+// schedcore.c). Every job is submitted to a SchedCore at its arrival time
+// and the core is advanced from timer to timer instead of following the
+// clock process, so a replay makes the decisions the scheduler binary makes,
+// I/O bursts included, and large traces can be replayed in-process. Arrivals
+// are handed to the core before the timers that fall due on the same tick,
+// the order the scheduler binary takes them in: it drains its messages
+// before advancing the core.
+//
+// The CPU and the I/O device are both work-conserving under every policy,
+// so whenever both go idle with nothing queued the rest of the trace no
+// longer depends on anything that happened before. Those idle points are
+// known in advance from arrival times and burst lengths alone, which gives
+// an exact lookahead: the trace is cut there into segments that host threads
+// replay on cores of their own. Jobs with dependencies may wait for parents
+// in an earlier segment, and some policies carry state from one busy period
+// to the next, so such a replay is done as one segment. Segments are fixed
+// by the trace and the policy, not by the thread count, and their results
+// are merged in trace order, so every thread count produces bit-identical
+// results, equal to those of a single core replaying the whole trace.
+
+#define SIM_SEGMENT_JOBS 4096 // Smallest segment worth handing to a thread
+
+typedef struct {
+    const Process* jobs;
+    int count;
+    double* wta;          // Weighted turnaround of each job, in the order they finished
+    bool rejected;        // The core refused a job
+    int end_time;
+    long busy_time;
+    long dispatches;
+    long preemptions;
+    double sum_waiting;
+} SimSegment;
+
+typedef struct {
+    SimSegment* segments;
+    int segment_count;
+    int next_segment;     // Next segment to claim, taken with an atomic add
+    int algorithm;
+    int quantum;
+} SimWork;
+
+// Function to describe a trace job for schedSubmit()
+static SchedJob simJob(const Process* process) {
+    SchedJob job;
+    memset(&job, 0, sizeof(job));
+    job.id = process->id;
+    job.priority = process->priority;
+    job.runtime = process->runtime;
+    if (process->burst_count > 1) {
+        job.burst_count = process->burst_count;
+        memcpy(job.bursts, process->bursts, process->burst_count * sizeof(int));
+    }
+    snprintf(job.group, sizeof(job.group), "%s", process->group_name);
+    job.group_weight = process->group_weight;
+    job.dep_count = process->dep_count;
+    memcpy(job.deps, process->deps, process->dep_count * sizeof(int));
+    job.critical_path = process->critical_path;
+    return job;
+}
+
+// Function to replay one segment of jobs (sorted by arrival time) that starts
+// with the CPU and the I/O device idle, on a core of its own
+static void simulateSegment(SimSegment* segment, int alg, int quantum) {
+    const Process* jobs = segment->jobs;
+    int count = segment->count;
+
+    SchedCore* core = schedCreate(alg, quantum);
+    if (core == NULL) {
+        segment->rejected = true;
+        return;
+    }
+    schedStartClock(core, jobs[0].arrival_time);
+
+    SchedDispatch dispatch;
+    for (int i = 0; i <= count; i++) {
+        // Past the last job, run the core until nothing is pending
+        int arrival = i < count ? jobs[i].arrival_time : INT_MAX;
+        schedNextDispatch(core, &dispatch);
+        while (dispatch.next_event != -1 && dispatch.next_event < arrival) {
+            schedAdvance(core, dispatch.next_event);
+            schedNextDispatch(core, &dispatch);
+        }
+        if (i == count) break;
+
+        schedSetTime(core, arrival);
+        SchedJob job = simJob(&jobs[i]);
+        if (schedSubmit(core, &job) == -1) segment->rejected = true;
+    }
+
+    segment->end_time = core->now;
+    segment->busy_time = core->total_runtime - core->idle_time;
+    segment->dispatches = core->dispatches;
+    segment->preemptions = core->preemptions;
+    segment->sum_waiting = core->total_finished_waiting;
+    if (core->finished_count != count) segment->rejected = true;
+    memcpy(segment->wta, core->weighted_turnaround_times, core->finished_count * sizeof(double));
+
+    schedDestroy(core);
+}
+
+// Function to tell whether a policy keeps nothing from one busy period to the
+// next but its ready queue, which is empty at an idle point. The others carry
+// state across (the lottery's random draws, stride and group passes, learned
+// burst predictions, the adaptive quantum's burst history).
+static bool simStateless(int alg, int quantum) {
+    return alg == HPF || alg == SRTN || alg == CRITICAL_PATH || (alg == RR && quantum != ADAPTIVE_QUANTUM);
+}
+
+// Function to cut jobs (sorted by arrival) at idle points into segments of at
+// least SIM_SEGMENT_JOBS jobs, returning the number of segments. While any
+// job is unfinished the CPU or the I/O device is busy, so all work admitted
+// so far is done by the time its bursts would take back to back.
+static int partitionTrace(const Process* jobs, int count, int alg, int quantum, SimSegment* segments) {
+    int segment_count = 0;
+    int start = 0;
+    long work_done_at = 0; // Time the CPU and the device clear all work admitted so far
+    bool whole = !simStateless(alg, quantum);
+    for (int i = 0; i < count; i++) {
+        if (jobs[i].dep_count > 0) whole = true;
+    }
+
+    for (int i = 0; i < count && !whole; i++) {
+        if (i - start >= SIM_SEGMENT_JOBS && jobs[i].arrival_time >= work_done_at) {
+            segments[segment_count].jobs = jobs + start;
+            segments[segment_count].count = i - start;
+            segment_count++;
+            start = i;
+        }
+        if (jobs[i].arrival_time > work_done_at) work_done_at = jobs[i].arrival_time;
+        if (jobs[i].burst_count > 1) {
+            for (int b = 0; b < jobs[i].burst_count; b++) work_done_at += jobs[i].bursts[b];
+        } else {
+            work_done_at += jobs[i].runtime;
+        }
+    }
+
+    segments[segment_count].jobs = jobs + start;
+    segments[segment_count].count = count - start;
+    return segment_count + 1;
+}
+
+// Function run by each host thread: claim segments until none are left
+static void* simWorker(void* arg) {
+    SimWork* work = (SimWork*)arg;
+    int index;
+    while ((index = __sync_fetch_and_add(&work->next_segment, 1)) < work->segment_count) {
+        simulateSegment(&work->segments[index], work->algorithm, work->quantum);
+    }
+    return NULL;
+}
+
+// Function to replay jobs (sorted by arrival time) on up to threads host
+// threads and collect the scheduler.perf metrics
+int simulateTraceParallel(const Process* jobs, int count, int alg, int quantum, int threads,
+                          SimResult* result) {
+    if (count <= 0 || alg < HPF || alg > ALGORITHM_COUNT) {
+        return -1;
+    }
+
+    SimSegment* segments = (SimSegment*)calloc(count / SIM_SEGMENT_JOBS + 1, sizeof(SimSegment));
+    SimWork work = { segments, partitionTrace(jobs, count, alg, quantum, segments), 0, alg, quantum };
+    double* wta = (double*)calloc(count, sizeof(double));
+    for (int i = 0; i < work.segment_count; i++) {
+        segments[i].wta = wta + (segments[i].jobs - jobs);
+    }
+
+    if (threads > work.segment_count) threads = work.segment_count;
+    if (threads <= 1) {
+        simWorker(&work);
+    } else {
+        // The calling thread works too
+        pthread_t* pool = (pthread_t*)malloc((threads - 1) * sizeof(pthread_t));
+        for (int i = 0; i < threads - 1; i++) {
+            pthread_create(&pool[i], NULL, simWorker, &work);
+        }
+        simWorker(&work);
+        for (int i = 0; i < threads - 1; i++) {
+            pthread_join(pool[i], NULL);
+        }
+        free(pool);
+    }
+
+    // Merge in trace order. Every job of a segment finishes before the next
+    // segment starts, so summing the turnarounds in this order adds them up
+    // exactly as a single core replaying the whole trace would.
+    memset(result, 0, sizeof(SimResult));
+    double sum_wta = 0, sum_wta_sq = 0, sum_waiting = 0;
+    bool rejected = false;
+    for (int i = 0; i < work.segment_count; i++) {
+        result->busy_time += segments[i].busy_time;
+        result->dispatches += segments[i].dispatches;
+        result->preemptions += segments[i].preemptions;
+        sum_waiting += segments[i].sum_waiting;
+        if (segments[i].rejected) rejected = true;
+    }
+    for (int i = 0; i < count; i++) {
+        sum_wta += wta[i];
+        sum_wta_sq += wta[i] * wta[i];
+    }
+
+    int time = segments[work.segment_count - 1].end_time;
+    result->segments = work.segment_count;
+    result->makespan = time;
+    result->cpu_utilization = time > 0 ? 100.0 * result->busy_time / time : 0;
+    result->avg_wta = sum_wta / count;
+    result->avg_waiting = sum_waiting / count;
+    double variance = sum_wta_sq / count - result->avg_wta * result->avg_wta;
+    result->std_wta = variance > 0 ? sqrt(variance) : 0;
+
+    free(wta);
+    free(segments);
+    return rejected ? -1 : 0;
+}
+
+// Function to replay jobs (sorted by arrival time) on the calling thread
+int simulateTrace(const Process* jobs, int count, int alg, int quantum, SimResult* result) {
+    return simulateTraceParallel(jobs, count, alg, quantum, 1, result);
+}
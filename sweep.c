@@ -0,0 +1,340 @@
+#include "headers.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+
+// Parallel parameter sweep: runs process_generator non-interactively for every
+// (trace, algorithm, quantum) combination and tabulates the scheduler.perf
+// metrics. Each run gets its own directory for its logs, and process_generator
+// gives every instance private IPC objects, so runs do not interfere.
+
+#define MAX_LIST 32
+#define MAX_RUNS 1024
+#define KILL_GRACE 5   // Seconds a timed-out run gets to exit after SIGINT
+
+typedef struct {
+    const char* trace;
+    int algorithm;
+    int quantum;
+    char dir[PATH_MAX];
+    int pid;
+    int status;      // Exit status of process_generator, -1 if it did not finish
+    bool timed_out;  // SIGINT sent when the timeout expired
+    bool killed;     // SIGKILL sent when it did not exit within KILL_GRACE
+    bool has_perf;   // Metrics read from a run that completed
+    double cpu_utilization;
+    double avg_wta;
+    double avg_waiting;
+    double std_wta;
+} SweepRun;
+
+SweepRun runs[MAX_RUNS];
+int run_count = 0;
+const char* algorithm_names[] = { "", "HPF", "SRTN", "RR", "LOTTERY", "STRIDE", "PSRTN",
+                                  "FAIR_HPF", "FAIR_SRTN", "FAIR_RR", "CP" };
+
+// Function to parse a comma-separated list of integers
+int parseIntList(const char* text, int* values) {
+    int count = 0;
+    char* copy = strdup(text);
+    for (char* token = strtok(copy, ","); token != NULL && count < MAX_LIST; token = strtok(NULL, ",")) {
+        values[count++] = atoi(token);
+    }
+    free(copy);
+    return count;
+}
+
+// Function to prepare a run directory with links to the binaries and the
+// trace. Output left by an earlier sweep in the same directory is removed, so
+// a run that fails cannot be reported with the metrics of an old one.
+int prepareRunDir(SweepRun* run) {
+    char cwd[PATH_MAX];
+    if (getcwd(cwd, sizeof(cwd)) == NULL) return -1;
+
+    if (mkdir(run->dir, 0755) == -1 && errno != EEXIST) {
+        perror("Error creating run directory");
+        return -1;
+    }
+
+    // The specialized scheduler may not have been built; process_generator
+    // falls back to the generic one when its link dangles
+    const char* engines[] = ENGINE_NAMES;
+    const char* binaries[] = { "clk", "process", "scheduler", "process_generator", engines[run->algorithm] };
+    char target[PATH_MAX * 2];
+    char link_path[PATH_MAX * 2];
+    for (int i = 0; i < 5; i++) {
+        snprintf(target, sizeof(target), "%s/%s", cwd, binaries[i]);
+        snprintf(link_path, sizeof(link_path), "%s/%s", run->dir, binaries[i]);
+        unlink(link_path);
+        if (symlink(target, link_path) == -1) {
+            perror("Error linking binary");
+            return -1;
+        }
+    }
+
+    if (run->trace[0] == '/') {
+        snprintf(target, sizeof(target), "%s", run->trace);
+    } else {
+        snprintf(target, sizeof(target), "%s/%s", cwd, run->trace);
+    }
+    snprintf(link_path, sizeof(link_path), "%s/processes.txt", run->dir);
+    unlink(link_path);
+    if (symlink(target, link_path) == -1) {
+        perror("Error linking trace");
+        return -1;
+    }
+
+    const char* outputs[] = { "scheduler.perf", "scheduler.log", "scheduler.trace", "run.out" };
+    for (int i = 0; i < 4; i++) {
+        snprintf(link_path, sizeof(link_path), "%s/%s", run->dir, outputs[i]);
+        if (unlink(link_path) == -1 && errno != ENOENT) {
+            perror("Error removing old output");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// Function to start one simulation in its own directory
+int startRun(SweepRun* run) {
+    int pid = fork();
+    if (pid == 0) {
+        if (chdir(run->dir) == -1) exit(1);
+
+        // Keep the per-run console output next to its logs
+        int out = open("run.out", O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        int in = open("/dev/null", O_RDONLY);
+        dup2(in, STDIN_FILENO);
+        dup2(out, STDOUT_FILENO);
+        dup2(out, STDERR_FILENO);
+
+        char alg_str[10], quantum_str[10];
+        sprintf(alg_str, "%d", run->algorithm);
+        sprintf(quantum_str, "%d", run->quantum);
+        execl("./process_generator", "process_generator", "-a", alg_str,
+              "-q", quantum_str, "-f", "processes.txt", NULL);
+        perror("Error executing process_generator");
+        exit(1);
+    }
+    run->pid = pid;
+    return pid;
+}
+
+// Function to read the metrics written by the scheduler of a run that
+// completed; an interrupted or failed run may have left a partial file
+void readPerfFile(SweepRun* run) {
+    if (run->status != 0) return;
+
+    char path[PATH_MAX + 16];
+    snprintf(path, sizeof(path), "%s/scheduler.perf", run->dir);
+    FILE* file = fopen(path, "r");
+    if (!file) return;
+
+    char line[128];
+    int found = 0;
+    while (fgets(line, sizeof(line), file)) {
+        found += sscanf(line, "CPU utilization = %lf", &run->cpu_utilization);
+        found += sscanf(line, "Avg WTA = %lf", &run->avg_wta);
+        found += sscanf(line, "Avg Waiting = %lf", &run->avg_waiting);
+        found += sscanf(line, "Std WTA = %lf", &run->std_wta);
+    }
+    run->has_perf = found == 4;
+    fclose(file);
+}
+
+// Function to remove the message queue of a run that had to be killed. Its
+// shared memory is already marked for removal and the generator's reaper
+// normally removes the queue as well; the queue is only removed here while the
+// dead generator is still its last sender, so an id reused by another run is
+// left alone.
+void releaseRunIpc(SweepRun* run) {
+    char path[PATH_MAX + 16];
+    snprintf(path, sizeof(path), "%s/%s", run->dir, INSTANCE_FILE);
+    int queue_id = readInstanceId(path, ENV_MSGQ);
+    struct msqid_ds info;
+    if (queue_id != -1 && msgctl(queue_id, IPC_STAT, &info) == 0 && info.msg_lspid == run->pid) {
+        if (msgctl(queue_id, IPC_RMID, NULL) == -1) {
+            printf("Warning: message queue %d of %s was left behind\n", queue_id, run->dir);
+        }
+    }
+    unlink(path);
+}
+
+// Function to get the width of the alg column, that of the longest name
+int algorithmWidth() {
+    int width = 0;
+    for (int i = 0; i <= ALGORITHM_COUNT; i++) {
+        int length = strlen(algorithm_names[i]);
+        if (length > width) width = length;
+    }
+    return width;
+}
+
+// Function to print the comparison table
+void printTable(FILE* out) {
+    int alg_width = algorithmWidth();
+    fprintf(out, "%-24s %-*s %7s %9s %9s %11s %9s  %s\n", "trace", alg_width, "alg", "quantum",
+            "cpu_util", "avg_wta", "avg_waiting", "std_wta", "status");
+    for (int i = 0; i < run_count; i++) {
+        SweepRun* run = &runs[i];
+        char quantum_str[12] = "-";
+        if (run->quantum == ADAPTIVE_QUANTUM && USES_QUANTUM(run->algorithm)) {
+            strcpy(quantum_str, "auto");
+        } else if (USES_QUANTUM(run->algorithm)) {
+            sprintf(quantum_str, "%d", run->quantum);
+        }
+
+        if (run->has_perf) {
+            fprintf(out, "%-24s %-*s %7s %8.2f%% %9.2f %11.2f %9.2f  ok\n", run->trace,
+                    alg_width, algorithm_names[run->algorithm], quantum_str, run->cpu_utilization,
+                    run->avg_wta, run->avg_waiting, run->std_wta);
+        } else {
+            const char* status = run->killed ? "killed" : run->timed_out ? "timed out" : "failed";
+            fprintf(out, "%-24s %-*s %7s %9s %9s %11s %9s  %s (see %s/run.out)\n",
+                    run->trace, alg_width, algorithm_names[run->algorithm], quantum_str,
+                    "-", "-", "-", "-", status, run->dir);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int algorithms[MAX_LIST] = { HPF, SRTN, RR };
+    int algorithm_count = 3;
+    int quanta[MAX_LIST] = { 1 };
+    int quantum_count = 1;
+    int jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int timeout = 0;
+    const char* base_dir = "sweep.runs";
+    const char* table_path = "sweep.txt";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "a:q:j:d:o:T:")) != -1) {
+        if (opt == 'a') {
+            algorithm_count = parseIntList(optarg, algorithms);
+        } else if (opt == 'q') {
+            quantum_count = parseIntList(optarg, quanta);
+        } else if (opt == 'j') {
+            jobs = atoi(optarg);
+        } else if (opt == 'd') {
+            base_dir = optarg;
+        } else if (opt == 'o') {
+            table_path = optarg;
+        } else if (opt == 'T') {
+            timeout = atoi(optarg);
+        } else {
+            printf("Usage: %s [-a 1,2,3] [-q 1,2,4] [-j jobs] [-d dir] [-o table] "
+                   "[-T timeout_sec] [trace ...]\n", argv[0]);
+            exit(1);
+        }
+    }
+    if (jobs <= 0) jobs = 1;
+
+    const char* default_trace = "processes.txt";
+    const char** traces = (const char**)&argv[optind];
+    int trace_count = argc - optind;
+    if (trace_count == 0) {
+        traces = &default_trace;
+        trace_count = 1;
+    }
+
+    // Expand the combinations; the quantum only matters for time-sliced algorithms
+    for (int t = 0; t < trace_count; t++) {
+        for (int a = 0; a < algorithm_count; a++) {
+            if (algorithms[a] < HPF || algorithms[a] > ALGORITHM_COUNT) {
+                printf("Error: unknown algorithm %d\n", algorithms[a]);
+                exit(1);
+            }
+            int variants = USES_QUANTUM(algorithms[a]) ? quantum_count : 1;
+            for (int q = 0; q < variants && run_count < MAX_RUNS; q++) {
+                SweepRun* run = &runs[run_count];
+                run->trace = traces[t];
+                run->algorithm = algorithms[a];
+                run->quantum = USES_QUANTUM(algorithms[a]) ? quanta[q] : 0;
+                run->status = -1;
+                snprintf(run->dir, sizeof(run->dir), "%s/run%03d", base_dir, run_count);
+                run_count++;
+            }
+        }
+    }
+
+    if (mkdir(base_dir, 0755) == -1 && errno != EEXIST) {
+        perror("Error creating sweep directory");
+        exit(1);
+    }
+
+    printf("Running %d simulations, %d at a time\n", run_count, jobs);
+
+    int active_runs[MAX_RUNS];
+    int active_count = 0;
+    int next_run = 0;
+    time_t started[MAX_RUNS];
+
+    while (next_run < run_count || active_count > 0) {
+        // Fill the free slots
+        while (next_run < run_count && active_count < jobs) {
+            SweepRun* run = &runs[next_run];
+            if (prepareRunDir(run) == -1) {
+                printf("Error: could not prepare %s\n", run->dir);
+                next_run++;
+                continue;
+            }
+            startRun(run);
+            started[next_run] = time(NULL);
+            active_runs[active_count] = next_run;
+            active_count++;
+            next_run++;
+        }
+
+        // Reap finished runs and enforce the timeout. SIGINT lets
+        // process_generator clear its IPC resources; one that has not exited
+        // KILL_GRACE seconds later is killed.
+        int status;
+        int pid = waitpid(-1, &status, timeout > 0 ? WNOHANG : 0);
+        if (pid == 0) {
+            for (int i = 0; i < active_count; i++) {
+                int r = active_runs[i];
+                if (runs[r].killed || time(NULL) - started[r] <= timeout) continue;
+                if (!runs[r].timed_out) {
+                    kill(runs[r].pid, SIGINT);
+                    runs[r].timed_out = true;
+                    started[r] = time(NULL) - timeout + KILL_GRACE;
+                } else {
+                    kill(runs[r].pid, SIGKILL);
+                    runs[r].killed = true;
+                }
+            }
+            usleep(200000);
+            continue;
+        }
+        if (pid == -1) break;
+
+        for (int i = 0; i < active_count; i++) {
+            SweepRun* run = &runs[active_runs[i]];
+            if (run->pid != pid) continue;
+
+            run->status = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+            if (run->killed) releaseRunIpc(run);
+            readPerfFile(run);
+            printf("Finished %s: %s %s\n", run->dir, run->trace, algorithm_names[run->algorithm]);
+            fflush(stdout);
+
+            active_count--;
+            active_runs[i] = active_runs[active_count];
+            break;
+        }
+    }
+
+    printf("\n");
+    printTable(stdout);
+
+    FILE* table = fopen(table_path, "w");
+    if (table) {
+        printTable(table);
+        fclose(table);
+        printf("\nTable written to %s\n", table_path);
+    }
+
+    return 0;
+}
@@ -3,12 +3,13 @@
 #include <time.h>
 
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        printf("Usage: %s <number_of_processes>\n", argv[0]);
+    if (argc != 2 && argc != 3) {
+        printf("Usage: %s <number_of_processes> [io_percent]\n", argv[0]);
         return 1;
     }
     
     int n = atoi(argv[1]);
+    int io_percent = argc == 3 ? atoi(argv[2]) : 0; // Share of jobs with I/O bursts
     if (n <= 0) {
         printf("Number of processes must be positive\n");
         return 1;
@@ -25,7 +26,7 @@ int main(int argc, char *argv[]) {
     }
     
     // Write header
-    fprintf(file, "#id\tarrival\truntime\tpriority\n");
+    fprintf(file, "#id\tarrival\truntime\tpriority\t[bursts=cpu,io,...,cpu] [group=name:weight] [deps=id,...]\n");
     
     // Generate processes
     for (int i = 1; i <= n; i++) {
@@ -33,7 +34,23 @@ int main(int argc, char *argv[]) {
         int runtime = 1 + rand() % 20;      // Runtime between 1-20
         int priority = rand() % 11;         // Priority between 0-10
         
-        fprintf(file, "%d\t%d\t%d\t%d\n", i, arrival, runtime, priority);
+        if (rand() % 100 >= io_percent || runtime < 2) {
+            fprintf(file, "%d\t%d\t%d\t%d\n", i, arrival, runtime, priority);
+            continue;
+        }
+        
+        // Split the runtime into 2-4 CPU bursts separated by I/O bursts of 1-5
+        int cpu_bursts = 2 + rand() % 3;
+        if (cpu_bursts > runtime) cpu_bursts = runtime;
+        fprintf(file, "%d\t%d\t%d\t%d\tbursts=", i, arrival, runtime, priority);
+        int left = runtime;
+        for (int b = 0; b < cpu_bursts; b++) {
+            int cpu = b == cpu_bursts - 1 ? left : 1 + rand() % (left - (cpu_bursts - b) + 1);
+            left -= cpu;
+            fprintf(file, "%d", cpu);
+            if (b < cpu_bursts - 1) fprintf(file, ",%d,", 1 + rand() % 5);
+        }
+        fprintf(file, "\n");
     }
     
     fclose(file);
@@ -0,0 +1,154 @@
+#include "headers.h"
+
+// Hierarchical timing wheel over clock ticks. Level L has TIMER_SLOTS slots of
+// TIMER_SLOTS^L ticks each; a timer sits on the lowest level whose range covers
+// its distance from now and moves down a level whenever the level below wraps.
+// Timers are intrusive doubly-linked nodes owned by the caller, so adding and
+// cancelling are O(1) and advancing costs O(1) per tick plus O(1) per timer
+// fired or moved, independent of how many timers are pending.
+
+// Function to make an empty list out of a sentinel node
+static void initTimerList(Timer* list) {
+    list->prev = list;
+    list->next = list;
+}
+
+// Function to append a timer to a list; same-tick timers fire in the order added
+static void appendTimer(Timer* list, Timer* timer) {
+    timer->prev = list->prev;
+    timer->next = list;
+    list->prev->next = timer;
+    list->prev = timer;
+}
+
+// Function to unlink a timer from whatever list holds it
+static void unlinkTimer(Timer* timer) {
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->prev = timer->next = NULL;
+}
+
+// Function to put a pending timer on the slot matching its distance from now
+static void placeTimer(TimerWheel* wheel, Timer* timer) {
+    long delta = (long)timer->expires - wheel->now;
+    if (delta <= 0) {
+        appendTimer(&wheel->due, timer);
+        return;
+    }
+
+    int level = 0;
+    while (level < TIMER_LEVELS - 1 && delta >= (1L << (TIMER_SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    // Beyond the top level's range the timer waits in its farthest slot and is
+    // placed again when that slot cascades
+    long expires = timer->expires;
+    if (delta >= (1L << (TIMER_SLOT_BITS * TIMER_LEVELS))) {
+        expires = wheel->now + (1L << (TIMER_SLOT_BITS * TIMER_LEVELS)) - 1;
+    }
+
+    int slot = (expires >> (TIMER_SLOT_BITS * level)) & (TIMER_SLOTS - 1);
+    appendTimer(&wheel->slots[level][slot], timer);
+}
+
+TimerWheel* createTimerWheel(int now) {
+    TimerWheel* wheel = (TimerWheel*)malloc(sizeof(TimerWheel));
+    wheel->now = now;
+    wheel->pending = 0;
+    initTimerList(&wheel->due);
+    for (int level = 0; level < TIMER_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_SLOTS; slot++) {
+            initTimerList(&wheel->slots[level][slot]);
+        }
+    }
+    return wheel;
+}
+
+// Function to prepare a timer node before its first use
+void initTimer(Timer* timer, int type, int data) {
+    timer->type = type;
+    timer->data = data;
+    timer->expires = 0;
+    timer->pending = false;
+    timer->prev = timer->next = NULL;
+}
+
+// Function to arm a timer for the given tick, re-arming it if already pending.
+// A tick at or before now fires on the next advance.
+void addTimer(TimerWheel* wheel, Timer* timer, int expires) {
+    if (timer->pending) {
+        cancelTimer(wheel, timer);
+    }
+    timer->expires = expires;
+    timer->pending = true;
+    wheel->pending++;
+    placeTimer(wheel, timer);
+}
+
+// Function to disarm a timer; cancelling one that is not pending does nothing
+void cancelTimer(TimerWheel* wheel, Timer* timer) {
+    if (!timer->pending) return;
+    unlinkTimer(timer);
+    timer->pending = false;
+    wheel->pending--;
+}
+
+// Function to move every timer of one slot to its place for the current tick
+static void cascadeSlot(TimerWheel* wheel, Timer* slot) {
+    Timer moved;
+    initTimerList(&moved);
+    if (slot->next != slot) {
+        moved.next = slot->next;
+        moved.prev = slot->prev;
+        moved.next->prev = &moved;
+        moved.prev->next = &moved;
+        initTimerList(slot);
+    }
+
+    while (moved.next != &moved) {
+        Timer* timer = moved.next;
+        unlinkTimer(timer);
+        placeTimer(wheel, timer);
+    }
+}
+
+// Function to fire everything on the due list; callbacks may add timers
+static int fireDueTimers(TimerWheel* wheel, TimerCallback callback) {
+    int fired = 0;
+    while (wheel->due.next != &wheel->due) {
+        Timer* timer = wheel->due.next;
+        unlinkTimer(timer);
+        timer->pending = false;
+        wheel->pending--;
+        fired++;
+        callback(timer);
+    }
+    return fired;
+}
+
+// Function to advance the wheel to now, firing every timer that expires on the
+// way in tick order. Returns the number of timers fired.
+int advanceTimerWheel(TimerWheel* wheel, int now, TimerCallback callback) {
+    int fired = fireDueTimers(wheel, callback);
+
+    while (wheel->now < now) {
+        wheel->now++;
+
+        // Higher levels move down one level each time the level below wraps
+        for (int level = 1; level < TIMER_LEVELS; level++) {
+            if ((wheel->now & ((1 << (TIMER_SLOT_BITS * level)) - 1)) != 0) break;
+            int slot = (wheel->now >> (TIMER_SLOT_BITS * level)) & (TIMER_SLOTS - 1);
+            cascadeSlot(wheel, &wheel->slots[level][slot]);
+        }
+
+        cascadeSlot(wheel, &wheel->slots[0][wheel->now & (TIMER_SLOTS - 1)]);
+        fired += fireDueTimers(wheel, callback);
+    }
+
+    return fired;
+}
+
+void destroyTimerWheel(TimerWheel* wheel) {
+    free(wheel);
+}
@@ -0,0 +1,62 @@
+#include "headers.h"
+
+// Binary event stream of scheduling decisions. Events are buffered in memory
+// and written in blocks, so recording costs a few stores per event.
+
+#define TRACE_BUFFER_EVENTS 4096
+
+FILE *trace_file = NULL;
+TraceEvent trace_buffer[TRACE_BUFFER_EVENTS];
+int trace_buffered = 0;
+
+// Function to create the trace file and write its header. A resumed run
+// appends to the trace of the original one, like it does to the log.
+int openTrace(const char* path, int algorithm, int quantum, bool resume) {
+    trace_file = fopen(path, resume ? "ab" : "wb");
+    if (!trace_file) {
+        perror("Error opening trace file");
+        return -1;
+    }
+
+    // The original trace may be missing, then the resumed run starts a new one
+    fseek(trace_file, 0, SEEK_END);
+    if (ftell(trace_file) == 0) {
+        TraceHeader header = { TRACE_MAGIC, 1, algorithm, quantum };
+        fwrite(&header, sizeof(header), 1, trace_file);
+    }
+    trace_buffered = 0;
+    return 0;
+}
+
+// Function to append one event to the stream
+void recordEvent(int time, int type, int process_id, int value) {
+    if (trace_file == NULL) return;
+
+    TraceEvent* event = &trace_buffer[trace_buffered++];
+    event->time = time;
+    event->type = type;
+    event->process_id = process_id;
+    event->value = value;
+
+    if (trace_buffered == TRACE_BUFFER_EVENTS) {
+        flushTrace();
+    }
+}
+
+// Function to write buffered events to the file
+void flushTrace() {
+    if (trace_file == NULL || trace_buffered == 0) return;
+
+    fwrite(trace_buffer, sizeof(TraceEvent), trace_buffered, trace_file);
+    fflush(trace_file);
+    trace_buffered = 0;
+}
+
+// Function to flush and close the trace
+void closeTrace() {
+    if (trace_file == NULL) return;
+
+    flushTrace();
+    fclose(trace_file);
+    trace_file = NULL;
+}
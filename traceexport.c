@@ -0,0 +1,117 @@
+#include "headers.h"
+#include <stdarg.h>
+
+// Converts the binary scheduler.trace stream into Chrome trace / Perfetto JSON.
+// Each process gets its own row with its run slices, a "CPU" row shows which
+// process held the CPU, I/O waits show as "blocked" slices, and queue-depth
+// samples become a counter track.
+
+#define US_PER_TICK 1000000L // One simulated clock tick is shown as one second
+
+const char* algorithm_names[] = { "", "HPF", "SRTN", "RR", "LOTTERY", "STRIDE", "PSRTN",
+                                  "FAIR_HPF", "FAIR_SRTN", "FAIR_RR", "CP" };
+
+// Function to print one JSON event, taking care of the separating comma
+void emitEvent(FILE* out, bool* first, const char* format, ...) {
+    va_list args;
+    fprintf(out, "%s\n    ", *first ? "" : ",");
+    *first = false;
+    va_start(args, format);
+    vfprintf(out, format, args);
+    va_end(args);
+}
+
+int main(int argc, char *argv[]) {
+    const char* input_path = argc > 1 ? argv[1] : TRACE_FILE;
+    const char* output_path = argc > 2 ? argv[2] : "scheduler.json";
+
+    FILE* in = fopen(input_path, "rb");
+    if (!in) {
+        perror("Error opening trace file");
+        exit(1);
+    }
+
+    TraceHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 || header.magic != TRACE_MAGIC) {
+        printf("Error: %s is not a scheduler trace\n", input_path);
+        exit(1);
+    }
+
+    FILE* out = fopen(output_path, "w");
+    if (!out) {
+        perror("Error opening output file");
+        exit(1);
+    }
+
+    const char* algorithm = header.algorithm >= HPF && header.algorithm <= ALGORITHM_COUNT
+                            ? algorithm_names[header.algorithm] : "unknown";
+    fprintf(out, "{\n  \"displayTimeUnit\": \"ms\",\n");
+    fprintf(out, "  \"otherData\": { \"algorithm\": \"%s\", \"quantum\": %d },\n",
+            algorithm, header.quantum);
+    fprintf(out, "  \"traceEvents\": [");
+
+    bool first = true;
+    emitEvent(out, &first, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, "
+              "\"args\": {\"name\": \"CPU\"}}");
+    emitEvent(out, &first, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, "
+              "\"args\": {\"name\": \"Processes\"}}");
+
+    TraceEvent event;
+    long count = 0;
+    while (fread(&event, sizeof(event), 1, in) == 1) {
+        long ts = event.time * US_PER_TICK;
+        count++;
+
+        switch (event.type) {
+        case EVENT_ARRIVAL:
+            emitEvent(out, &first, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+                      "\"tid\": %d, \"args\": {\"name\": \"P%d\"}}", event.process_id, event.process_id);
+            emitEvent(out, &first, "{\"name\": \"arrival\", \"ph\": \"i\", \"s\": \"t\", "
+                      "\"ts\": %ld, \"pid\": 1, \"tid\": %d, \"args\": {\"runtime\": %d}}",
+                      ts, event.process_id, event.value);
+            break;
+        case EVENT_DISPATCH:
+        case EVENT_RESUME:
+            emitEvent(out, &first, "{\"name\": \"%s\", \"ph\": \"B\", \"ts\": %ld, \"pid\": 1, "
+                      "\"tid\": %d, \"args\": {\"remaining\": %d}}",
+                      event.type == EVENT_DISPATCH ? "run" : "resume", ts,
+                      event.process_id, event.value);
+            emitEvent(out, &first, "{\"name\": \"P%d\", \"ph\": \"B\", \"ts\": %ld, \"pid\": 0, "
+                      "\"tid\": 0}", event.process_id, ts);
+            break;
+        case EVENT_PREEMPT:
+        case EVENT_FINISH:
+            emitEvent(out, &first, "{\"ph\": \"E\", \"ts\": %ld, \"pid\": 1, \"tid\": %d, "
+                      "\"args\": {\"%s\": %d}}", ts, event.process_id,
+                      event.type == EVENT_PREEMPT ? "preempted_remaining" : "finished", event.value);
+            emitEvent(out, &first, "{\"ph\": \"E\", \"ts\": %ld, \"pid\": 0, \"tid\": 0}", ts);
+            break;
+        case EVENT_BLOCK:
+            emitEvent(out, &first, "{\"ph\": \"E\", \"ts\": %ld, \"pid\": 1, \"tid\": %d}",
+                      ts, event.process_id);
+            emitEvent(out, &first, "{\"ph\": \"E\", \"ts\": %ld, \"pid\": 0, \"tid\": 0}", ts);
+            emitEvent(out, &first, "{\"name\": \"blocked\", \"ph\": \"B\", \"ts\": %ld, \"pid\": 1, "
+                      "\"tid\": %d, \"args\": {\"io_burst\": %d}}", ts, event.process_id, event.value);
+            break;
+        case EVENT_RELEASE:
+            emitEvent(out, &first, "{\"name\": \"released\", \"ph\": \"i\", \"s\": \"t\", "
+                      "\"ts\": %ld, \"pid\": 1, \"tid\": %d}", ts, event.process_id);
+            break;
+        case EVENT_IO_DONE:
+            emitEvent(out, &first, "{\"ph\": \"E\", \"ts\": %ld, \"pid\": 1, \"tid\": %d}",
+                      ts, event.process_id);
+            break;
+        case EVENT_QUEUE_DEPTH:
+            emitEvent(out, &first, "{\"name\": \"ready queue\", \"ph\": \"C\", \"ts\": %ld, "
+                      "\"pid\": 0, \"args\": {\"depth\": %d}}", ts, event.value);
+            break;
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    fclose(out);
+    fclose(in);
+
+    printf("Converted %ld events from %s to %s\n", count, input_path, output_path);
+    return 0;
+}